@@ -0,0 +1,177 @@
+#include "async_http_client.h"
+
+#include <curl/curl.h>
+
+#include <stdexcept>
+
+#include "connection_pool.h"
+#include "latency.h"
+#include "tracer.h"
+
+namespace standx {
+
+struct AsyncHttpClient::Request {
+  std::string method;
+  std::string url;
+  std::string body;
+  struct curl_slist* headers{nullptr};
+  CURL* easy{nullptr};
+  HttpResponse response;
+  Callback callback;
+  LatencyHistogram* latency{nullptr};
+};
+
+AsyncHttpClient::AsyncHttpClient() : running_(true), thread_("http-loop") {
+  // Make sure the pool (and curl_global_init) exists before the multi handle.
+  ConnectionPool::instance();
+
+  CURLM* multi = curl_multi_init();
+  if (!multi) throw std::runtime_error("curl multi init failed");
+  curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+  multi_ = multi;
+  thread_.start(*this);
+}
+
+AsyncHttpClient::~AsyncHttpClient() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  curl_multi_wakeup((CURLM*)multi_);
+  thread_.join();
+  curl_multi_cleanup((CURLM*)multi_);
+}
+
+size_t AsyncHttpClient::write_callback(void* contents, size_t size,
+                                       size_t nmemb, void* userp) {
+  ((std::string*)userp)->append((char*)contents, size * nmemb);
+  return size * nmemb;
+}
+
+void AsyncHttpClient::submit(const std::string& method, const std::string& url,
+                             const std::vector<std::string>& headers,
+                             const std::string& body, Callback callback) {
+  Request* req = new Request;
+  req->method = method;
+  req->url = url;
+  req->body = body;
+  req->callback = std::move(callback);
+  for (const auto& h : headers) {
+    req->headers = curl_slist_append(req->headers, h.c_str());
+  }
+
+  INFO_("api", "send async " << method << " " << url << ", body:" << body);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.push_back(req);
+  }
+  curl_multi_wakeup((CURLM*)multi_);
+}
+
+std::future<HttpResponse> AsyncHttpClient::submit(
+    const std::string& method, const std::string& url,
+    const std::vector<std::string>& headers, const std::string& body) {
+  auto promise = std::make_shared<std::promise<HttpResponse>>();
+  std::future<HttpResponse> future = promise->get_future();
+  submit(method, url, headers, body, [promise](HttpResponse& resp) {
+    promise->set_value(std::move(resp));
+  });
+  return future;
+}
+
+void AsyncHttpClient::start_pending() {
+  std::deque<Request*> batch;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    batch.swap(pending_);
+  }
+
+  for (Request* req : batch) {
+    CURL* curl = (CURL*)ConnectionPool::instance().acquire(req->url);
+    req->easy = curl;
+    curl_easy_setopt(curl, CURLOPT_URL, req->url.c_str());
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, req->headers);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &req->response.body);
+    curl_easy_setopt(curl, CURLOPT_PRIVATE, req);
+    curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+    curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST,
+                     req->method.empty() ? nullptr : req->method.c_str());
+    if (!req->body.empty()) {
+      curl_easy_setopt(curl, CURLOPT_POSTFIELDS, req->body.c_str());
+      curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, (long)req->body.size());
+    } else {
+      curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
+    }
+    req->latency = &endpointLatency(req->method, req->url);
+    req->response.sent_ns = monoNowNs();
+    curl_multi_add_handle((CURLM*)multi_, curl);
+    inflight_.insert(req);
+  }
+}
+
+void AsyncHttpClient::finish(void* easy, int result) {
+  CURL* curl = (CURL*)easy;
+  Request* req = nullptr;
+  curl_easy_getinfo(curl, CURLINFO_PRIVATE, (char**)&req);
+  curl_multi_remove_handle((CURLM*)multi_, curl);
+  inflight_.erase(req);
+  req->response.received_ns = monoNowNs();
+  req->latency->record(req->response.received_ns - req->response.sent_ns);
+
+  curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &req->response.code);
+  if (result != CURLE_OK) {
+    req->response.error = curl_easy_strerror((CURLcode)result);
+  }
+  INFO_("api", "async response: " << req->response.code << " "
+                                  << req->response.body);
+
+  curl_easy_setopt(curl, CURLOPT_HTTPHEADER, nullptr);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, nullptr);
+  curl_easy_setopt(curl, CURLOPT_PRIVATE, nullptr);
+  curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 0L);
+  ConnectionPool::instance().release(req->url, curl, result == CURLE_OK);
+  curl_slist_free_all(req->headers);
+
+  try {
+    if (req->callback) req->callback(req->response);
+  } catch (const std::exception& e) {
+    ERROR("async http callback error: " << e.what());
+  }
+  delete req;
+}
+
+void AsyncHttpClient::run() {
+  CURLM* multi = (CURLM*)multi_;
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!running_) break;
+    }
+    start_pending();
+
+    int still_running = 0;
+    curl_multi_perform(multi, &still_running);
+
+    int msgs_left = 0;
+    while (CURLMsg* msg = curl_multi_info_read(multi, &msgs_left)) {
+      if (msg->msg == CURLMSG_DONE) {
+        finish(msg->easy_handle, msg->data.result);
+      }
+    }
+
+    curl_multi_poll(multi, nullptr, 0, 1000, nullptr);
+  }
+
+  // Fail whatever is still queued or in flight so no future is left hanging.
+  start_pending();
+  int msgs_left = 0;
+  while (CURLMsg* msg = curl_multi_info_read(multi, &msgs_left)) {
+    if (msg->msg == CURLMSG_DONE) finish(msg->easy_handle, msg->data.result);
+  }
+  while (!inflight_.empty()) {
+    finish((*inflight_.begin())->easy, CURLE_ABORTED_BY_CALLBACK);
+  }
+}
+
+}  // namespace standx
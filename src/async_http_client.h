@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+
+namespace standx {
+
+struct HttpResponse {
+    long code{0};        // HTTP status, 0 when the transfer itself failed
+    std::string body;
+    std::string error;   // curl error text when the transfer failed
+    int64_t sent_ns{0};      // monoNowNs() when handed to curl
+    int64_t received_ns{0};  // monoNowNs() when the transfer completed
+
+    bool ok() const { return error.empty() && code >= 200 && code < 300; }
+};
+
+// Non-blocking HTTP engine: one event-loop thread drives a curl multi handle,
+// so many requests can be in flight at once on the pooled keep-alive
+// connections. Completion is reported through a callback (run on the loop
+// thread, keep it short) or a future.
+class AsyncHttpClient : public Poco::Runnable {
+public:
+    using Callback = std::function<void(HttpResponse&)>;
+
+    AsyncHttpClient();
+    ~AsyncHttpClient();
+
+    // headers are full header lines, e.g. "Content-Type: application/json"
+    void submit(const std::string& method, const std::string& url,
+                const std::vector<std::string>& headers, const std::string& body,
+                Callback callback);
+
+    std::future<HttpResponse> submit(const std::string& method, const std::string& url,
+                                     const std::vector<std::string>& headers,
+                                     const std::string& body);
+
+    void run() override;
+
+private:
+    struct Request;
+
+    static size_t write_callback(void* contents, size_t size, size_t nmemb, void* userp);
+    void start_pending();
+    void finish(void* easy, int result);
+
+    void* multi_;
+    bool running_;
+    Poco::Thread thread_;
+    std::mutex mutex_;
+    std::deque<Request*> pending_;
+    std::set<Request*> inflight_;  // loop thread only
+};
+
+} // namespace standx
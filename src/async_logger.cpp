@@ -0,0 +1,395 @@
+#include "async_logger.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include "Poco/Exception.h"
+#include "Poco/Logger.h"
+#include "Poco/Message.h"
+#include "Poco/Thread.h"
+#include "Poco/Timestamp.h"
+
+namespace logger {
+
+OverflowPolicy ParseOverflowPolicy(const std::string &name) {
+  return name == "block" ? OverflowPolicy::kBlock : OverflowPolicy::kDrop;
+}
+
+// ---------------------------------------------------------------------------
+// LogLine
+
+class LogLine::Buffer : public std::streambuf {
+ public:
+  Buffer() : storage_(512), stream_(this) {
+    flags_ = stream_.flags();
+    precision_ = stream_.precision();
+    fill_ = stream_.fill();
+    Reset();
+  }
+
+  // Rewind and undo any manipulators the previous message left behind.
+  void Reset() {
+    setp(storage_.data(), storage_.data() + storage_.size());
+    stream_.clear();
+    stream_.flags(flags_);
+    stream_.precision(precision_);
+    stream_.width(0);
+    stream_.fill(fill_);
+  }
+
+  std::ostream &stream() { return stream_; }
+  const char *data() const { return pbase(); }
+  size_t size() const { return static_cast<size_t>(pptr() - pbase()); }
+
+ protected:
+  int_type overflow(int_type ch) override {
+    if (traits_type::eq_int_type(ch, traits_type::eof())) {
+      return traits_type::not_eof(ch);
+    }
+    Reserve(1);
+    *pptr() = traits_type::to_char_type(ch);
+    pbump(1);
+    return ch;
+  }
+
+  std::streamsize xsputn(const char *s, std::streamsize n) override {
+    Reserve(static_cast<size_t>(n));
+    std::memcpy(pptr(), s, static_cast<size_t>(n));
+    pbump(static_cast<int>(n));
+    return n;
+  }
+
+ private:
+  void Reserve(size_t n) {
+    size_t used = size();
+    if (used + n <= storage_.size()) return;
+    size_t capacity = storage_.size() * 2;
+    while (capacity < used + n) capacity *= 2;
+    storage_.resize(capacity);
+    setp(storage_.data(), storage_.data() + storage_.size());
+    pbump(static_cast<int>(used));
+  }
+
+  std::vector<char> storage_;
+  std::ostream stream_;
+  std::ios_base::fmtflags flags_;
+  std::streamsize precision_;
+  char fill_;
+};
+
+// One buffer per nesting level: a value whose operator<< logs by itself
+// must not write into the buffer of the message it is part of.
+struct LogLine::Pool {
+  static Pool &local() {
+    thread_local Pool pool;
+    return pool;
+  }
+
+  std::vector<std::unique_ptr<Buffer>> buffers;
+  size_t depth{0};
+};
+
+namespace {
+
+size_t roundUpPow2(size_t n) {
+  size_t p = 4096;
+  while (p < n) p <<= 1;
+  return p;
+}
+
+}  // namespace
+
+LogLine::LogLine() {
+  Pool &pool = Pool::local();
+  if (pool.depth == pool.buffers.size()) {
+    pool.buffers.emplace_back(new Buffer());
+  }
+  buffer_ = pool.buffers[pool.depth++].get();
+  buffer_->Reset();
+}
+
+LogLine::~LogLine() { --Pool::local().depth; }
+
+std::ostream &LogLine::stream() { return buffer_->stream(); }
+
+const char *LogLine::data() const { return buffer_->data(); }
+
+size_t LogLine::size() const { return buffer_->size(); }
+
+// ---------------------------------------------------------------------------
+// AsyncLogger
+
+// A record in the ring: this header, then text_size bytes of text, padded
+// to 8 bytes. A header with no logger marks the unused tail of the ring
+// before a wrap; a gap too short for a header is skipped implicitly.
+struct AsyncLogger::RecordHeader {
+  uint32_t size;  // whole record, header and padding included
+  int32_t priority;
+  int32_t line;
+  uint32_t text_size;
+  int64_t time_us;  // wall clock, as Poco::Timestamp
+  Poco::Logger *logger;
+  const char *file;
+};
+
+// Positions are byte counts that only grow; the offset in the buffer is
+// the position masked by capacity - 1.
+struct AsyncLogger::Ring {
+  explicit Ring(size_t bytes) : data(new char[bytes]), capacity(bytes) {}
+
+  std::unique_ptr<char[]> data;
+  const size_t capacity;
+  std::string thread_name;
+  long tid{0};
+  std::atomic<bool> closed{false};  // producing thread has exited
+
+  alignas(64) std::atomic<uint64_t> head{0};  // written by the producer
+  uint64_t cached_tail{0};                    // producer's view of tail
+  alignas(64) std::atomic<uint64_t> tail{0};  // written by the writer
+};
+
+namespace {
+
+constexpr size_t kAlign = 8;
+
+size_t alignUp(size_t n) { return (n + kAlign - 1) & ~(kAlign - 1); }
+
+}  // namespace
+
+AsyncLogger &AsyncLogger::instance() {
+  static AsyncLogger logger;
+  return logger;
+}
+
+AsyncLogger::~AsyncLogger() { Stop(); }
+
+void AsyncLogger::Start(size_t ring_bytes, OverflowPolicy policy) {
+  if (running()) return;
+  ring_bytes_ = roundUpPow2(ring_bytes);
+  policy_ = policy;
+  running_.store(true, std::memory_order_release);
+  writer_ = std::thread(&AsyncLogger::Run, this);
+}
+
+void AsyncLogger::Stop() {
+  if (!running_.exchange(false)) return;
+  if (writer_.joinable()) writer_.join();
+  // A producer that saw running_ still true is finishing its record; the
+  // last drain must come after it.
+  while (pushing_.load(std::memory_order_seq_cst) != 0) {
+    std::this_thread::yield();
+  }
+  while (Drain()) {
+  }
+  flushed_.notify_all();
+}
+
+AsyncLogger::Ring *AsyncLogger::LocalRing() {
+  // Owns this thread's ring; marks it closed when the thread exits so the
+  // writer can drop it once drained.
+  struct Holder {
+    std::shared_ptr<Ring> ring;
+    ~Holder() {
+      if (ring) ring->closed.store(true, std::memory_order_release);
+    }
+  };
+  thread_local Holder holder;
+  if (!holder.ring || holder.ring->capacity != ring_bytes_) {
+    if (holder.ring) holder.ring->closed.store(true, std::memory_order_release);
+    auto ring = std::make_shared<Ring>(ring_bytes_);
+    Poco::Thread *thread = Poco::Thread::current();
+    ring->thread_name = thread ? thread->getName() : "main";
+    ring->tid = static_cast<long>(Poco::Thread::currentTid());
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    rings_.push_back(ring);
+    holder.ring = std::move(ring);
+  }
+  return holder.ring.get();
+}
+
+bool AsyncLogger::Push(Poco::Logger *logger, int priority, const char *file,
+                       int line, const char *text, size_t size) {
+  // Announce the push before checking running_, while Stop() clears
+  // running_ before checking pushing_: with both seq_cst, either Stop()
+  // waits for this record or this call sees the logger stopped.
+  pushing_.fetch_add(1, std::memory_order_seq_cst);
+  if (!running_.load(std::memory_order_seq_cst)) {
+    pushing_.fetch_sub(1, std::memory_order_release);
+    return false;
+  }
+
+  Ring *ring = LocalRing();
+  const size_t capacity = ring->capacity;
+
+  // Keep every record well below the ring size so one long message (an
+  // API body) cannot stall the thread behind a half-empty ring.
+  const size_t max_text = capacity / 4 - sizeof(RecordHeader);
+  if (size > max_text) size = max_text;
+  const size_t need = alignUp(sizeof(RecordHeader) + size);
+
+  uint64_t head = ring->head.load(std::memory_order_relaxed);
+  size_t offset = static_cast<size_t>(head & (capacity - 1));
+  size_t to_end = capacity - offset;
+  size_t total = need <= to_end ? need : to_end + need;
+
+  if (head + total - ring->cached_tail > capacity) {
+    ring->cached_tail = ring->tail.load(std::memory_order_acquire);
+    while (head + total - ring->cached_tail > capacity) {
+      if (policy_ == OverflowPolicy::kDrop || !running()) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        pushing_.fetch_sub(1, std::memory_order_release);
+        return true;
+      }
+      std::this_thread::yield();
+      ring->cached_tail = ring->tail.load(std::memory_order_acquire);
+    }
+  }
+
+  if (need > to_end) {
+    if (to_end >= sizeof(RecordHeader)) {
+      auto *marker =
+          reinterpret_cast<RecordHeader *>(ring->data.get() + offset);
+      marker->size = static_cast<uint32_t>(to_end);
+      marker->logger = nullptr;
+    }
+    head += to_end;
+    offset = 0;
+  }
+
+  auto *record = reinterpret_cast<RecordHeader *>(ring->data.get() + offset);
+  record->size = static_cast<uint32_t>(need);
+  record->priority = priority;
+  record->line = line;
+  record->text_size = static_cast<uint32_t>(size);
+  record->time_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::system_clock::now().time_since_epoch())
+                        .count();
+  record->logger = logger;
+  record->file = file;
+  std::memcpy(record + 1, text, size);
+
+  ring->head.store(head + need, std::memory_order_release);
+  pushing_.fetch_sub(1, std::memory_order_release);
+  return true;
+}
+
+bool AsyncLogger::Drain() {
+  std::vector<std::shared_ptr<Ring>> rings;
+  {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    rings = rings_;
+  }
+
+  bool wrote = false;
+  for (auto &ring : rings) {
+    const size_t capacity = ring->capacity;
+    uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+    const uint64_t head = ring->head.load(std::memory_order_acquire);
+    while (tail < head) {
+      size_t offset = static_cast<size_t>(tail & (capacity - 1));
+      size_t to_end = capacity - offset;
+      if (to_end < sizeof(RecordHeader)) {
+        tail += to_end;
+        continue;
+      }
+      const auto *record =
+          reinterpret_cast<const RecordHeader *>(ring->data.get() + offset);
+      if (record->logger != nullptr) {
+        try {
+          Poco::Message msg(
+              record->logger->name(),
+              std::string(reinterpret_cast<const char *>(record + 1),
+                          record->text_size),
+              static_cast<Poco::Message::Priority>(record->priority),
+              record->file, record->line);
+          msg.setTime(Poco::Timestamp(record->time_us));
+          msg.setThread(ring->thread_name);
+          msg.setTid(ring->tid);
+          record->logger->log(msg);
+        } catch (const Poco::Exception &e) {
+          perror(e.what());
+        }
+        written_.fetch_add(1, std::memory_order_relaxed);
+        wrote = true;
+      }
+      tail += record->size;
+      // Hand the space back record by record so a blocked producer
+      // resumes as early as possible.
+      ring->tail.store(tail, std::memory_order_release);
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    for (auto it = rings_.begin(); it != rings_.end();) {
+      Ring &ring = **it;
+      if (ring.closed.load(std::memory_order_acquire) &&
+          ring.tail.load(std::memory_order_relaxed) ==
+              ring.head.load(std::memory_order_acquire)) {
+        it = rings_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+  if (dropped != reported_dropped_) {
+    try {
+      Poco::Logger &root = Poco::Logger::get("default");
+      Poco::Message msg(root.name(),
+                        "async log ring full, dropped " +
+                            std::to_string(dropped - reported_dropped_) +
+                            " records",
+                        Poco::Message::PRIO_WARNING);
+      root.log(msg);
+    } catch (const Poco::Exception &e) {
+      perror(e.what());
+    }
+    reported_dropped_ = dropped;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(flush_mutex_);
+  }
+  flushed_.notify_all();
+  return wrote;
+}
+
+void AsyncLogger::Run() {
+  while (running()) {
+    if (!Drain()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+void AsyncLogger::Flush() {
+  if (!running()) return;
+  std::vector<std::pair<std::shared_ptr<Ring>, uint64_t>> targets;
+  {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    for (auto &ring : rings_) {
+      targets.emplace_back(ring, ring->head.load(std::memory_order_acquire));
+    }
+  }
+  auto done = [&] {
+    if (!running()) return true;
+    for (auto &target : targets) {
+      if (target.first->tail.load(std::memory_order_acquire) < target.second) {
+        return false;
+      }
+    }
+    return true;
+  };
+  std::unique_lock<std::mutex> lock(flush_mutex_);
+  while (!done()) flushed_.wait_for(lock, std::chrono::milliseconds(10));
+}
+
+AsyncLogger::Stats AsyncLogger::stats() const {
+  Stats stats;
+  stats.written = written_.load(std::memory_order_relaxed);
+  stats.dropped = dropped_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+}  // namespace logger
@@ -0,0 +1,127 @@
+#ifndef _ASYNC_LOGGER_H
+#define _ASYNC_LOGGER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Poco {
+class Logger;
+}
+
+namespace logger {
+
+// What a producer does when its ring is full.
+enum class OverflowPolicy {
+  kDrop,   // count the record as dropped and return at once
+  kBlock,  // wait for the writer thread to make room
+};
+
+OverflowPolicy ParseOverflowPolicy(const std::string &name);
+
+/*!
+ * @class logger.LogLine
+ * @brief thread-local, reused text buffer that one log macro formats into,
+ *        so a log call does not construct a stringstream. A log call made
+ *        while a message is being formatted gets a buffer of its own.
+ */
+class LogLine {
+ public:
+  LogLine();
+  ~LogLine();
+
+  LogLine(const LogLine &) = delete;
+  LogLine &operator=(const LogLine &) = delete;
+
+  std::ostream &stream();
+  const char *data() const;
+  size_t size() const;
+
+ private:
+  class Buffer;
+  struct Pool;
+
+  Buffer *buffer_;
+};
+
+/*!
+ * @class logger.AsyncLogger
+ * @brief moves formatting into Poco::Message and all file I/O (including
+ *        rotation) off the calling threads.
+ *
+ * Each producing thread owns a single-producer single-consumer byte ring.
+ * A log call copies one compact record (logger, priority, source location,
+ * timestamp and text) into it with no lock and no allocation; the writer
+ * thread drains every ring and hands the records to the Poco channels.
+ * Records of one thread stay in order; records of different threads are
+ * interleaved by the writer, each keeping its original timestamp.
+ */
+class AsyncLogger {
+ public:
+  struct Stats {
+    uint64_t written{0};  // records handed to the channels
+    uint64_t dropped{0};  // records lost to full rings (kDrop)
+  };
+
+  static AsyncLogger &instance();
+
+  // ring_bytes is per producing thread, rounded up to a power of two.
+  void Start(size_t ring_bytes, OverflowPolicy policy);
+  // Write out everything queued, then stop the writer thread. Waits for
+  // Push calls already under way, so their records are written too.
+  void Stop();
+  bool running() const { return running_.load(std::memory_order_acquire); }
+
+  // Queue one record; file must have static storage (a literal such as
+  // the base name of __FILE__). False when the logger has stopped; the
+  // caller then writes the record itself.
+  bool Push(Poco::Logger *logger, int priority, const char *file, int line,
+            const char *text, size_t size);
+
+  // Block until every record queued before the call has been written.
+  void Flush();
+
+  Stats stats() const;
+
+ private:
+  struct Ring;
+  struct RecordHeader;
+
+  AsyncLogger() = default;
+  ~AsyncLogger();
+  AsyncLogger(const AsyncLogger &) = delete;
+  AsyncLogger &operator=(const AsyncLogger &) = delete;
+
+  Ring *LocalRing();
+  // Write out what the rings hold; true if anything was written.
+  bool Drain();
+  void Run();
+
+  std::atomic<bool> running_{false};
+  std::atomic<int> pushing_{0};  // Push calls in progress
+  size_t ring_bytes_{0};
+  OverflowPolicy policy_{OverflowPolicy::kDrop};
+  std::thread writer_;
+
+  std::mutex rings_mutex_;
+  std::vector<std::shared_ptr<Ring>> rings_;
+
+  std::mutex flush_mutex_;
+  std::condition_variable flushed_;
+
+  std::atomic<uint64_t> written_{0};
+  std::atomic<uint64_t> dropped_{0};
+  uint64_t reported_dropped_{0};  // writer thread only
+};
+
+}  // namespace logger
+
+#endif  // _ASYNC_LOGGER_H
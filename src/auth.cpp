@@ -21,6 +21,7 @@ struct AuthManager::Impl {
     secp256k1_context* ctx;
     unsigned char ed25519_pk[crypto_sign_PUBLICKEYBYTES];  // Ed25519 public key
     unsigned char ed25519_sk[crypto_sign_SECRETKEYBYTES];  // Ed25519 secret key
+    HttpClient http;  // reused across logins so token refresh rides a warm connection
 
     Impl() {
         ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
@@ -32,8 +33,8 @@ struct AuthManager::Impl {
     }
 };
 
-AuthManager::AuthManager(const std::string& chain)
-    : impl_(new Impl()), chain_(chain), auth_base_url_("https://api.standx.com") {
+AuthManager::AuthManager(const std::string& chain, const std::string& base_url)
+    : impl_(new Impl()), chain_(chain), auth_base_url_(base_url) {
     if (sodium_init() < 0) {
         throw std::runtime_error("libsodium init failed");
     }
@@ -74,7 +75,7 @@ std::string AuthManager::login(int expires_seconds) {
 
     std::string request_id = base58_encode(impl_->ed25519_pk, crypto_sign_PUBLICKEYBYTES);
 
-    HttpClient http;
+    HttpClient& http = impl_->http;
     std::string prepare_url = auth_base_url_ + "/v1/offchain/prepare-signin?chain=" + chain_;
     json jreq;
     jreq["address"] = address_;
@@ -235,14 +236,21 @@ std::string AuthManager::sign_ecdsa_64_base64(const std::string& message) {
 }
 
 std::string AuthManager::sign_ed25519_base64(const std::string& message) {
+    // Ed25519 signature (64 bytes)
+    unsigned char signature[crypto_sign_BYTES];
+    sign_ed25519(message, signature);
+
+    // Base64 encode (64 bytes)
+    return base64_encode(signature, crypto_sign_BYTES);
+}
+
+void AuthManager::sign_ed25519(const std::string& message,
+                               unsigned char* signature) {
     if (private_key_bytes_.empty()) {
         throw std::runtime_error("private key not set");
     }
 
-    // Ed25519 signature (64 bytes)
-    unsigned char signature[crypto_sign_BYTES];
     unsigned long long sig_len;
-
     crypto_sign_detached(
         signature,
         &sig_len,
@@ -250,9 +258,6 @@ std::string AuthManager::sign_ed25519_base64(const std::string& message) {
         message.size(),
         impl_->ed25519_sk
     );
-
-    // Base64 encode (64 bytes)
-    return base64_encode(signature, crypto_sign_BYTES);
 }
 
 bool AuthManager::verify_jwt(const std::string& signed_data) {
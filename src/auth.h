@@ -7,7 +7,8 @@ namespace standx {
 
 class AuthManager {
 public:
-    AuthManager(const std::string& chain);
+    AuthManager(const std::string& chain,
+                const std::string& base_url = "https://api.standx.com");
     ~AuthManager();
 
     // Set private key (hex format with or without 0x prefix)
@@ -34,6 +35,9 @@ public:
     // Sign using Ed25519 (libsodium) and return base64 - matches official API
     std::string sign_ed25519_base64(const std::string& message);
 
+    // Raw Ed25519 signature of message into signature (64 bytes)
+    void sign_ed25519(const std::string& message, unsigned char* signature);
+
     // Verify JWT signedData
     bool verify_jwt(const std::string& signed_data);
 
@@ -0,0 +1,57 @@
+#include "backtest.h"
+
+#include <chrono>
+#include <cmath>
+#include <memory>
+
+#include "strategy.h"
+
+namespace standx {
+
+BacktestResult runBacktest(const Tick* ticks, size_t count,
+                           const BacktestOptions& options) {
+  BacktestResult result;
+  if (count == 0) return result;
+  auto started = std::chrono::steady_clock::now();
+
+  GridParams params = options.params
+                          ? *options.params
+                          : Strategy::DefaultParams(options.sim.symbol);
+  auto sim = std::make_shared<SimExchange>(options.sim);
+  // The strategy reads the price and positions while it initialises.
+  sim->onTick(ticks[0].ts_ms, ticks[0].price);
+  Strategy strategy(sim, nullptr, params);
+
+  int64_t last_step = ticks[0].ts_ms;
+  int64_t last_level = INT64_MIN;
+  for (size_t i = 0; i < count; ++i) {
+    const Tick& tick = ticks[i];
+    sim->onTick(tick.ts_ms, tick.price);
+    int64_t level =
+        static_cast<int64_t>(std::floor(tick.price / params.order_interval));
+    bool due = options.step_ms <= 0 || level != last_level ||
+               tick.ts_ms - last_step >= options.step_ms;
+    if (!due) continue;
+    strategy.Step();
+    last_step = tick.ts_ms;
+    last_level = level;
+    ++result.steps;
+  }
+
+  result.stats = sim->stats();
+  result.final_equity = sim->equity();
+  result.ticks = count;
+  result.first_ts_ms = ticks[0].ts_ms;
+  result.last_ts_ms = ticks[count - 1].ts_ms;
+  result.wall_seconds = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - started)
+                            .count();
+  return result;
+}
+
+BacktestResult runBacktest(const std::vector<Tick>& ticks,
+                           const BacktestOptions& options) {
+  return runBacktest(ticks.data(), ticks.size(), options);
+}
+
+}  // namespace standx
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "data.h"
+#include "sim_exchange.h"
+#include "tick_file.h"
+
+namespace standx {
+
+struct BacktestOptions {
+    SimConfig sim;
+    // Grid shape; Strategy::DefaultParams(sim.symbol) when unset.
+    std::optional<GridParams> params;
+    // Timer interval in simulated ms. As in the live event loop the
+    // strategy also steps whenever the price crosses a grid level. 0 steps
+    // on every tick.
+    int64_t step_ms{1000};
+};
+
+struct BacktestResult {
+    SimStats stats;
+    double final_equity{0.0};
+    size_t ticks{0};
+    size_t steps{0};
+    int64_t first_ts_ms{0};
+    int64_t last_ts_ms{0};
+    double wall_seconds{0.0};
+};
+
+// Replay ticks through an unmodified Strategy trading on a SimExchange.
+// Grid switches and sizes come from kConfig, as in live trading.
+BacktestResult runBacktest(const Tick* ticks, size_t count,
+                           const BacktestOptions& options);
+
+BacktestResult runBacktest(const std::vector<Tick>& ticks,
+                           const BacktestOptions& options);
+
+}  // namespace standx
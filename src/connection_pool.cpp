@@ -0,0 +1,150 @@
+#include "connection_pool.h"
+
+#include <curl/curl.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "tracer.h"
+
+namespace standx {
+
+namespace {
+
+std::mutex kShareLocks[CURL_LOCK_DATA_LAST];
+
+void share_lock(CURL*, curl_lock_data data, curl_lock_access, void*) {
+  kShareLocks[data].lock();
+}
+
+void share_unlock(CURL*, curl_lock_data data, void*) {
+  kShareLocks[data].unlock();
+}
+
+}  // namespace
+
+ConnectionPool& ConnectionPool::instance() {
+  static ConnectionPool pool;
+  return pool;
+}
+
+ConnectionPool::ConnectionPool()
+    : share_(nullptr), max_per_host_(4), idle_timeout_ms_(60000) {
+  curl_global_init(CURL_GLOBAL_DEFAULT);
+
+  CURLSH* share = curl_share_init();
+  if (!share) throw std::runtime_error("curl share init failed");
+  curl_share_setopt(share, CURLSHOPT_LOCKFUNC, share_lock);
+  curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, share_unlock);
+  curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+  curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+  curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+  share_ = share;
+}
+
+ConnectionPool::~ConnectionPool() {
+  for (auto& host : idle_) {
+    for (auto& h : host.second) curl_easy_cleanup((CURL*)h.curl);
+  }
+  idle_.clear();
+  if (share_) curl_share_cleanup((CURLSH*)share_);
+}
+
+void ConnectionPool::configure(size_t max_per_host, long idle_timeout_ms) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (max_per_host > 0) max_per_host_ = max_per_host;
+  if (idle_timeout_ms > 0) idle_timeout_ms_ = idle_timeout_ms;
+  INFO("Connection pool configured, max per host: "
+       << max_per_host_ << ", idle timeout ms: " << idle_timeout_ms_);
+}
+
+std::string ConnectionPool::host_key(const std::string& url) {
+  size_t scheme = url.find("://");
+  size_t start = (scheme == std::string::npos) ? 0 : scheme + 3;
+  size_t end = url.find_first_of("/?#", start);
+  return url.substr(0, end);
+}
+
+void* ConnectionPool::create_handle() {
+  CURL* curl = curl_easy_init();
+  if (!curl) throw std::runtime_error("curl init failed");
+
+  // Options that stay constant for the lifetime of the handle; per-request
+  // options are set by HttpClient on every transfer.
+  curl_easy_setopt(curl, CURLOPT_SHARE, (CURLSH*)share_);
+  curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+  curl_easy_setopt(curl, CURLOPT_TCP_KEEPIDLE, 30L);
+  curl_easy_setopt(curl, CURLOPT_TCP_KEEPINTVL, 15L);
+  curl_easy_setopt(curl, CURLOPT_TCP_NODELAY, 1L);
+  curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+  curl_easy_setopt(curl, CURLOPT_MAXCONNECTS, (long)max_per_host_);
+  curl_easy_setopt(curl, CURLOPT_MAXAGE_CONN,
+                   std::max(1L, idle_timeout_ms_ / 1000));
+  ++stats_.handles_created;
+  return curl;
+}
+
+void* ConnectionPool::acquire(const std::string& url) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  evict_idle_locked(Clock::now());
+
+  auto it = idle_.find(host_key(url));
+  if (it != idle_.end() && !it->second.empty()) {
+    void* curl = it->second.back().curl;
+    it->second.pop_back();
+    return curl;
+  }
+  return create_handle();
+}
+
+void ConnectionPool::release(const std::string& url, void* handle,
+                             bool reusable) {
+  if (!handle) return;
+
+  long connects = 0;
+  curl_easy_getinfo((CURL*)handle, CURLINFO_NUM_CONNECTS, &connects);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++stats_.requests;
+  if (connects == 0) {
+    ++stats_.reused;
+  } else {
+    stats_.connects += connects;
+  }
+
+  auto& bucket = idle_[host_key(url)];
+  if (!reusable || bucket.size() >= max_per_host_) {
+    curl_easy_cleanup((CURL*)handle);
+    ++stats_.handles_evicted;
+    return;
+  }
+  bucket.push_back({handle, Clock::now()});
+}
+
+void ConnectionPool::evict_idle() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  evict_idle_locked(Clock::now());
+}
+
+void ConnectionPool::evict_idle_locked(Clock::time_point now) {
+  auto timeout = std::chrono::milliseconds(idle_timeout_ms_);
+  for (auto& host : idle_) {
+    auto& handles = host.second;
+    for (auto it = handles.begin(); it != handles.end();) {
+      if (now - it->last_used > timeout) {
+        curl_easy_cleanup((CURL*)it->curl);
+        ++stats_.handles_evicted;
+        it = handles.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+}
+
+ConnectionPoolStats ConnectionPool::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+}  // namespace standx
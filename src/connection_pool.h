@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace standx {
+
+struct ConnectionPoolStats {
+    uint64_t requests{0};         // transfers performed through pooled handles
+    uint64_t reused{0};           // transfers that did not open a new connection
+    uint64_t connects{0};         // new TCP(+TLS) connections opened by curl
+    uint64_t handles_created{0};  // easy handles created by the pool
+    uint64_t handles_evicted{0};  // idle handles closed by the pool
+
+    double reuse_rate() const {
+        return requests == 0 ? 0.0 : (double)reused / (double)requests;
+    }
+};
+
+// Process-wide pool of keep-alive curl easy handles, grouped per host.
+// All handles share one DNS / TLS session / connection cache, so a handle
+// taken from the pool normally carries a warm TCP+TLS connection.
+class ConnectionPool {
+public:
+    static ConnectionPool& instance();
+
+    // Max idle handles kept per host, and how long an idle handle (and its
+    // connection) may stay in the pool before being closed.
+    void configure(size_t max_per_host, long idle_timeout_ms);
+
+    // Take a handle for the host of url; creates one if none is idle.
+    void* acquire(const std::string& url);
+
+    // Return a handle after a transfer; reusable=false closes it instead.
+    void release(const std::string& url, void* handle, bool reusable);
+
+    // Close handles that stayed idle longer than the idle timeout.
+    void evict_idle();
+
+    ConnectionPoolStats stats() const;
+
+private:
+    ConnectionPool();
+    ~ConnectionPool();
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    using Clock = std::chrono::steady_clock;
+
+    struct IdleHandle {
+        void* curl;
+        Clock::time_point last_used;
+    };
+
+    static std::string host_key(const std::string& url);
+    void* create_handle();
+    void evict_idle_locked(Clock::time_point now);
+
+    mutable std::mutex mutex_;
+    std::map<std::string, std::vector<IdleHandle>> idle_;
+    void* share_;
+    size_t max_per_host_;
+    long idle_timeout_ms_;
+    ConnectionPoolStats stats_;
+};
+
+} // namespace standx
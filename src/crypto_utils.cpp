@@ -1,15 +1,27 @@
 #include "crypto_utils.h"
 
+#include <cstdint>
 #include <cstring>
-#include <iomanip>
-#include <sstream>
 #include <stdexcept>
 
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define STANDX_CODEC_SSSE3 1
+#else
+#define STANDX_CODEC_SSSE3 0
+#endif
+
 namespace standx {
 
 typedef unsigned long long u64;
+// Four Keccak lanes side by side; the permutation below runs on it
+// unchanged, and the compiler maps it onto SIMD registers where it can.
+typedef u64 u64x4 __attribute__((vector_size(32)));
+
+#define ROL64(a, offset) (((a) << (offset)) ^ ((a) >> (64 - (offset))))
 
-#define ROL64(a, offset) ((a << offset) ^ (a >> (64 - offset)))
+static const size_t kKeccakRate = 136;  // 1088-bit rate of Keccak-256
+static const size_t kKeccakWays = 4;
 
 static const u64 keccakf_rndc[24] = {
     0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
@@ -21,190 +33,493 @@ static const u64 keccakf_rndc[24] = {
     0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
     0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL};
 
-static const int keccakf_rotc[24] = {1,  3,  6,  10, 15, 21, 28, 36,
-                                     45, 55, 2,  14, 27, 41, 56, 8,
-                                     25, 43, 62, 18, 39, 61, 20, 44};
+// Lanes are little-endian byte strings whatever the host order; memcpy
+// keeps the loads legal for any input alignment.
+static inline u64 load64_le(const unsigned char* p) {
+  u64 v;
+  memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  v = __builtin_bswap64(v);
+#endif
+  return v;
+}
 
-static const int keccakf_piln[24] = {10, 7,  11, 17, 18, 3,  5,  16,
-                                     8,  21, 24, 4,  15, 23, 19, 13,
-                                     12, 2,  20, 14, 22, 9,  6,  1};
+static inline void store64_le(unsigned char* p, u64 v) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  v = __builtin_bswap64(v);
+#endif
+  memcpy(p, &v, sizeof(v));
+}
 
-static void keccakf(u64 s[25]) {
-  int i, j, round;
-  u64 t, bc[5];
+template <typename Lane>
+static inline void keccak_chi(Lane* a, const Lane* b) {
+  a[0] = b[0] ^ (~b[1] & b[2]);
+  a[1] = b[1] ^ (~b[2] & b[3]);
+  a[2] = b[2] ^ (~b[3] & b[4]);
+  a[3] = b[3] ^ (~b[4] & b[0]);
+  a[4] = b[4] ^ (~b[0] & b[1]);
+}
 
-  for (round = 0; round < 24; round++) {
-    for (i = 0; i < 5; i++)
-      bc[i] = s[i] ^ s[i + 5] ^ s[i + 10] ^ s[i + 15] ^ s[i + 20];
+// Keccak-f[1600] with theta, rho/pi and chi written out lane by lane.
+// Lane is u64 for one state or u64x4 for four independent ones.
+template <typename Lane>
+static void keccak_f1600(Lane a[25]) {
+  Lane b[25];
+  for (int round = 0; round < 24; ++round) {
+    Lane c0 = a[0] ^ a[5] ^ a[10] ^ a[15] ^ a[20];
+    Lane c1 = a[1] ^ a[6] ^ a[11] ^ a[16] ^ a[21];
+    Lane c2 = a[2] ^ a[7] ^ a[12] ^ a[17] ^ a[22];
+    Lane c3 = a[3] ^ a[8] ^ a[13] ^ a[18] ^ a[23];
+    Lane c4 = a[4] ^ a[9] ^ a[14] ^ a[19] ^ a[24];
+    Lane d0 = c4 ^ ROL64(c1, 1);
+    Lane d1 = c0 ^ ROL64(c2, 1);
+    Lane d2 = c1 ^ ROL64(c3, 1);
+    Lane d3 = c2 ^ ROL64(c4, 1);
+    Lane d4 = c3 ^ ROL64(c0, 1);
+
+    b[0] = a[0] ^ d0;
+    b[1] = ROL64(a[6] ^ d1, 44);
+    b[2] = ROL64(a[12] ^ d2, 43);
+    b[3] = ROL64(a[18] ^ d3, 21);
+    b[4] = ROL64(a[24] ^ d4, 14);
+    b[5] = ROL64(a[3] ^ d3, 28);
+    b[6] = ROL64(a[9] ^ d4, 20);
+    b[7] = ROL64(a[10] ^ d0, 3);
+    b[8] = ROL64(a[16] ^ d1, 45);
+    b[9] = ROL64(a[22] ^ d2, 61);
+    b[10] = ROL64(a[1] ^ d1, 1);
+    b[11] = ROL64(a[7] ^ d2, 6);
+    b[12] = ROL64(a[13] ^ d3, 25);
+    b[13] = ROL64(a[19] ^ d4, 8);
+    b[14] = ROL64(a[20] ^ d0, 18);
+    b[15] = ROL64(a[4] ^ d4, 27);
+    b[16] = ROL64(a[5] ^ d0, 36);
+    b[17] = ROL64(a[11] ^ d1, 10);
+    b[18] = ROL64(a[17] ^ d2, 15);
+    b[19] = ROL64(a[23] ^ d3, 56);
+    b[20] = ROL64(a[2] ^ d2, 62);
+    b[21] = ROL64(a[8] ^ d3, 55);
+    b[22] = ROL64(a[14] ^ d4, 39);
+    b[23] = ROL64(a[15] ^ d0, 41);
+    b[24] = ROL64(a[21] ^ d1, 2);
+
+    keccak_chi(a, b);
+    keccak_chi(a + 5, b + 5);
+    keccak_chi(a + 10, b + 10);
+    keccak_chi(a + 15, b + 15);
+    keccak_chi(a + 20, b + 20);
+
+    a[0] ^= keccakf_rndc[round];
+  }
+}
 
-    for (i = 0; i < 5; i++) {
-      t = bc[(i + 4) % 5] ^ ROL64(bc[(i + 1) % 5], 1);
-      for (j = 0; j < 25; j += 5) s[j + i] ^= t;
-    }
+// Copies the tail of a message into a full block with the 0x01 ... 0x80
+// Keccak padding.
+static void keccak_pad(const unsigned char* in, size_t len,
+                       unsigned char block[kKeccakRate]) {
+  memset(block, 0, kKeccakRate);
+  memcpy(block, in, len);
+  block[len] = 0x01;
+  block[kKeccakRate - 1] |= 0x80;
+}
 
-    t = s[1];
-    for (i = 0; i < 24; i++) {
-      j = keccakf_piln[i];
-      bc[0] = s[j];
-      s[j] = ROL64(t, keccakf_rotc[i]);
-      t = bc[0];
-    }
+static void keccak_256_impl(const unsigned char* in, size_t inlen,
+                            unsigned char* out) {
+  u64 s[25] = {};
+  unsigned char last[kKeccakRate];
+  size_t i;
 
-    for (j = 0; j < 25; j += 5) {
-      for (i = 0; i < 5; i++) bc[i] = s[j + i];
-      for (i = 0; i < 5; i++) s[j + i] ^= (~bc[(i + 1) % 5]) & bc[(i + 2) % 5];
+  while (inlen >= kKeccakRate) {
+    for (i = 0; i < kKeccakRate / 8; i++) {
+      s[i] ^= load64_le(in + 8 * i);
     }
+    keccak_f1600(s);
+    in += kKeccakRate;
+    inlen -= kKeccakRate;
+  }
+
+  keccak_pad(in, inlen, last);
+  for (i = 0; i < kKeccakRate / 8; i++) {
+    s[i] ^= load64_le(last + 8 * i);
+  }
+  keccak_f1600(s);
 
-    s[0] ^= keccakf_rndc[round];
+  for (i = 0; i < 4; i++) {
+    store64_le(out + 8 * i, s[i]);
   }
 }
 
-static void keccak_256_impl(const unsigned char* in, size_t inlen,
-                            unsigned char* out) {
-  u64 s[25];
-  unsigned char temp[144];
-  size_t rate = 136;
-  size_t i;
+// Hashes up to four messages through one interleaved state. Each message
+// absorbs its own blocks; one that has already taken its padded block is
+// permuted along with the others but its digest was saved right after.
+static void keccak_256_x4(const unsigned char* const* in,
+                          const size_t* inlen, unsigned char* const* out,
+                          size_t count) {
+  u64x4 s[25] = {};
+  unsigned char last[kKeccakWays][kKeccakRate];
+  size_t full[kKeccakWays];
+  size_t steps = 0;
+  size_t i, w;
+
+  for (w = 0; w < count; w++) {
+    full[w] = inlen[w] / kKeccakRate;
+    keccak_pad(in[w] + full[w] * kKeccakRate, inlen[w] % kKeccakRate,
+               last[w]);
+    if (full[w] + 1 > steps) steps = full[w] + 1;
+  }
+
+  for (size_t step = 0; step < steps; step++) {
+    for (w = 0; w < count; w++) {
+      const unsigned char* block;
+      if (step < full[w]) {
+        block = in[w] + step * kKeccakRate;
+      } else if (step == full[w]) {
+        block = last[w];
+      } else {
+        continue;
+      }
+      for (i = 0; i < kKeccakRate / 8; i++) {
+        s[i][w] ^= load64_le(block + 8 * i);
+      }
+    }
+    keccak_f1600(s);
+    for (w = 0; w < count; w++) {
+      if (step != full[w]) continue;
+      for (i = 0; i < 4; i++) {
+        store64_le(out[w] + 8 * i, s[i][w]);
+      }
+    }
+  }
+}
+
+static const char* BASE58_ALPHABET =
+    "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+
+static const char kBase64Chars[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
-  memset(s, 0, sizeof(s));
+// Two lowercase hex digits for every byte value.
+struct HexPairs {
+  char text[256][2];
 
-  while (inlen >= rate) {
-    for (i = 0; i < rate / 8; i++) {
-      s[i] ^= ((u64*)in)[i];
+  constexpr HexPairs() : text() {
+    const char digits[] = "0123456789abcdef";
+    for (int i = 0; i < 256; ++i) {
+      text[i][0] = digits[i >> 4];
+      text[i][1] = digits[i & 0x0F];
     }
-    keccakf(s);
-    in += rate;
-    inlen -= rate;
   }
+};
 
-  memset(temp, 0, sizeof(temp));
-  memcpy(temp, in, inlen);
-  temp[inlen] = 0x01;
-  temp[rate - 1] |= 0x80;
+// Value of every hex digit of either case; 0xFF for other characters.
+struct HexValues {
+  unsigned char value[256];
 
-  for (i = 0; i < rate / 8; i++) {
-    s[i] ^= ((u64*)temp)[i];
+  constexpr HexValues() : value() {
+    for (int i = 0; i < 256; ++i) value[i] = 0xFF;
+    for (int i = 0; i < 10; ++i) value['0' + i] = static_cast<unsigned char>(i);
+    for (int i = 0; i < 6; ++i) {
+      value['a' + i] = value['A' + i] = static_cast<unsigned char>(10 + i);
+    }
+  }
+};
+
+// Value of every character of the standard and URL-safe base64 alphabets;
+// 0xFF for '=' and everything else.
+struct Base64Values {
+  unsigned char value[256];
+
+  constexpr Base64Values() : value() {
+    for (int i = 0; i < 256; ++i) value[i] = 0xFF;
+    for (int i = 0; i < 64; ++i) {
+      value[static_cast<unsigned char>(kBase64Chars[i])] =
+          static_cast<unsigned char>(i);
+    }
+    value['-'] = 62;
+    value['_'] = 63;
+  }
+};
+
+static constexpr HexPairs kHexPairs;
+static constexpr HexValues kHexValues;
+static constexpr Base64Values kBase64Values;
+
+static const uint64_t kBase58Limb = 656356768;  // 58^5
+// Inputs up to this many bytes (after leading zeros) use stack limbs.
+static const size_t kBase58MaxFastInput = 224;
+static const size_t kBase58MaxLimbs =
+    (kBase58MaxFastInput * 138 / 100 + 1) / 5 + 2;
+
+// Digit-at-a-time base58 for inputs too long for the stack limbs; the
+// digits are worked out in place in out.
+static size_t base58_encode_bytewise(const unsigned char* bytes, size_t len,
+                                     char* out) {
+  size_t size = base58_encoded_max_size(len);
+  unsigned char* digits = reinterpret_cast<unsigned char*>(out);
+  memset(digits, 0, size);
+  size_t j = 0;
+  for (size_t i = 0; i < len; ++i) {
+    int carry = bytes[i];
+    size_t k = 0;
+    for (size_t d = size; (carry != 0 || k < j) && d > 0; --d, ++k) {
+      carry += 256 * digits[d - 1];
+      digits[d - 1] = static_cast<unsigned char>(carry % 58);
+      carry /= 58;
+    }
+    j = k;
   }
-  keccakf(s);
+  size_t first = size - j;
+  while (first < size && digits[first] == 0) ++first;
+  size_t n = size - first;
+  for (size_t i = 0; i < n; ++i) out[i] = BASE58_ALPHABET[digits[first + i]];
+  return n;
+}
 
-  memcpy(out, s, 32);
+#if STANDX_CODEC_SSSE3
+static bool cpu_has_ssse3() {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("ssse3");
 }
 
-static const char* BASE58_ALPHABET =
-    "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+static const bool kHasSsse3 = cpu_has_ssse3();
+
+// 16 bytes to 32 digits per step; returns the bytes consumed.
+__attribute__((target("ssse3"))) static size_t hex_encode_ssse3(
+    const unsigned char* data, size_t len, char* out) {
+  const __m128i digits = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                       '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+  const __m128i nibble = _mm_set1_epi8(0x0F);
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    __m128i hi = _mm_shuffle_epi8(
+        digits, _mm_and_si128(_mm_srli_epi16(v, 4), nibble));
+    __m128i lo = _mm_shuffle_epi8(digits, _mm_and_si128(v, nibble));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i),
+                     _mm_unpacklo_epi8(hi, lo));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i + 16),
+                     _mm_unpackhi_epi8(hi, lo));
+  }
+  return i;
+}
+
+// 12 bytes to 16 characters per step (W. Mula's pshufb encoder); loads 16
+// bytes, so it stops while at least 16 remain. Returns the bytes consumed.
+__attribute__((target("ssse3"))) static size_t base64_encode_ssse3(
+    const unsigned char* data, size_t len, char* out) {
+  const __m128i spread =
+      _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+  const __m128i shift = _mm_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+  size_t i = 0;
+  char* p = out;
+  for (; i + 16 <= len; i += 12, p += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    v = _mm_shuffle_epi8(v, spread);
+    // Move each 6-bit field into a byte of its own.
+    __m128i a = _mm_mulhi_epu16(_mm_and_si128(v, _mm_set1_epi32(0x0FC0FC00)),
+                                _mm_set1_epi32(0x04000040));
+    __m128i b = _mm_mullo_epi16(_mm_and_si128(v, _mm_set1_epi32(0x003F03F0)),
+                                _mm_set1_epi32(0x01000010));
+    __m128i index = _mm_or_si128(a, b);
+    // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12, then
+    // the offset in shift turns the index into its character.
+    __m128i range = _mm_subs_epu8(index, _mm_set1_epi8(51));
+    __m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), index);
+    range = _mm_or_si128(range, _mm_and_si128(upper, _mm_set1_epi8(13)));
+    __m128i chars = _mm_add_epi8(_mm_shuffle_epi8(shift, range), index);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), chars);
+  }
+  return i;
+}
+#endif
 
 void keccak256(const unsigned char* in, size_t inlen, unsigned char* out) {
   keccak_256_impl(in, inlen, out);
 }
 
-std::vector<unsigned char> hex_to_bytes(const std::string& hex) {
-  auto hex_char_to_int = [](char c) -> int {
-    if (c >= '0' && c <= '9') return c - '0';
-    if (c >= 'a' && c <= 'f') return 10 + (c - 'a');
-    if (c >= 'A' && c <= 'F') return 10 + (c - 'A');
-    return -1;
-  };
-
-  std::string s = hex;
-  if (s.size() >= 2 && s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) {
-    s = s.substr(2);
-  }
-  if (s.size() % 2) throw std::runtime_error("invalid hex length");
-
-  std::vector<unsigned char> out;
-  out.reserve(s.size() / 2);
-  for (size_t i = 0; i < s.size(); i += 2) {
-    int hi = hex_char_to_int(s[i]);
-    int lo = hex_char_to_int(s[i + 1]);
-    if (hi < 0 || lo < 0) throw std::runtime_error("invalid hex character");
-    out.push_back((unsigned char)((hi << 4) | lo));
+void keccak256_multi(const unsigned char* const* in, const size_t* inlen,
+                     unsigned char* const* out, size_t count) {
+  while (count >= 2) {
+    size_t n = count < kKeccakWays ? count : kKeccakWays;
+    keccak_256_x4(in, inlen, out, n);
+    in += n;
+    inlen += n;
+    out += n;
+    count -= n;
   }
-  return out;
+  if (count == 1) keccak_256_impl(in[0], inlen[0], out[0]);
 }
 
-std::string bytes_to_hex(const unsigned char* data, size_t len) {
-  std::ostringstream ss;
-  ss << std::hex << std::setfill('0');
-  for (size_t i = 0; i < len; ++i) {
-    ss << std::setw(2) << (int)data[i];
+size_t hex_encode(const unsigned char* data, size_t len, char* out) {
+  size_t i = 0;
+#if STANDX_CODEC_SSSE3
+  if (kHasSsse3) i = hex_encode_ssse3(data, len, out);
+#endif
+  for (; i < len; ++i) {
+    memcpy(out + 2 * i, kHexPairs.text[data[i]], 2);
   }
-  return ss.str();
+  return hex_encoded_size(len);
 }
 
-std::string base58_encode(const unsigned char* bytes, size_t len) {
-  std::vector<unsigned char> input(bytes, bytes + len);
+bool hex_decode(const char* in, size_t len, unsigned char* out) {
+  if (len % 2) return false;
+  unsigned char bad = 0;
+  for (size_t i = 0; i < len; i += 2) {
+    unsigned char hi = kHexValues.value[static_cast<unsigned char>(in[i])];
+    unsigned char lo = kHexValues.value[static_cast<unsigned char>(in[i + 1])];
+    bad |= hi | lo;
+    out[i / 2] = static_cast<unsigned char>((hi << 4) | (lo & 0x0F));
+  }
+  return (bad & 0xF0) == 0;
+}
+
+size_t base64_encode(const unsigned char* data, size_t len, char* out) {
+  size_t i = 0;
+  char* p = out;
+#if STANDX_CODEC_SSSE3
+  if (kHasSsse3) {
+    i = base64_encode_ssse3(data, len, out);
+    p += i / 3 * 4;
+  }
+#endif
+  for (; i + 3 <= len; i += 3, p += 4) {
+    unsigned int val = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
+    p[0] = kBase64Chars[val >> 18];
+    p[1] = kBase64Chars[(val >> 12) & 0x3F];
+    p[2] = kBase64Chars[(val >> 6) & 0x3F];
+    p[3] = kBase64Chars[val & 0x3F];
+  }
+  if (i < len) {
+    bool two = i + 1 < len;
+    unsigned int val = (data[i] << 16) | (two ? data[i + 1] << 8 : 0);
+    p[0] = kBase64Chars[val >> 18];
+    p[1] = kBase64Chars[(val >> 12) & 0x3F];
+    p[2] = two ? kBase64Chars[(val >> 6) & 0x3F] : '=';
+    p[3] = '=';
+    p += 4;
+  }
+  return static_cast<size_t>(p - out);
+}
+
+size_t base64_decode(const char* in, size_t len, unsigned char* out) {
+  const unsigned char* s = reinterpret_cast<const unsigned char*>(in);
+  unsigned char* p = out;
+  size_t i = 0;
+  for (; i + 4 <= len; i += 4, p += 3) {
+    unsigned int a = kBase64Values.value[s[i]];
+    unsigned int b = kBase64Values.value[s[i + 1]];
+    unsigned int c = kBase64Values.value[s[i + 2]];
+    unsigned int d = kBase64Values.value[s[i + 3]];
+    if ((a | b | c | d) & 0x80) break;
+    unsigned int val = (a << 18) | (b << 12) | (c << 6) | d;
+    p[0] = static_cast<unsigned char>(val >> 16);
+    p[1] = static_cast<unsigned char>(val >> 8);
+    p[2] = static_cast<unsigned char>(val);
+  }
+  // The last group: fewer than four characters, or one cut short by '='
+  // or an invalid character.
+  unsigned int val = 0;
+  int bits = 0;
+  for (; i < len; ++i) {
+    unsigned char c = kBase64Values.value[s[i]];
+    if (c & 0x80) break;
+    val = (val << 6) | c;
+    bits += 6;
+    if (bits >= 8) {
+      bits -= 8;
+      *p++ = static_cast<unsigned char>(val >> bits);
+    }
+  }
+  return static_cast<size_t>(p - out);
+}
+
+size_t base58_encode(const unsigned char* bytes, size_t len, char* out) {
   size_t zeros = 0;
-  while (zeros < input.size() && input[zeros] == 0) ++zeros;
+  while (zeros < len && bytes[zeros] == 0) ++zeros;
+  char* p = out;
+  for (size_t i = 0; i < zeros; ++i) *p++ = '1';
 
-  std::vector<unsigned char> b58((input.size() - zeros) * 138 / 100 + 1);
-  size_t j = 0;
-  for (size_t i = zeros; i < input.size(); ++i) {
-    int carry = input[i];
-    size_t k = 0;
-    for (auto it = b58.rbegin(); (carry != 0 || k < j) && it != b58.rend();
-         ++it, ++k) {
-      carry += 256 * (*it);
-      *it = carry % 58;
-      carry /= 58;
+  size_t rest = len - zeros;
+  if (rest > kBase58MaxFastInput) {
+    return zeros + base58_encode_bytewise(bytes + zeros, rest, p);
+  }
+
+  // Limbs of five base-58 digits, least significant first, fed four input
+  // bytes at a time (the leading len % 4 bytes first).
+  uint32_t limbs[kBase58MaxLimbs];
+  size_t used = 0;
+  size_t i = zeros;
+  size_t head = rest % 4;
+  while (i < len) {
+    size_t n = i == zeros && head != 0 ? head : 4;
+    uint64_t carry = 0;
+    for (size_t k = 0; k < n; ++k) carry = (carry << 8) | bytes[i + k];
+    i += n;
+    for (size_t k = 0; k < used; ++k) {
+      carry += static_cast<uint64_t>(limbs[k]) << (8 * n);
+      limbs[k] = static_cast<uint32_t>(carry % kBase58Limb);
+      carry /= kBase58Limb;
+    }
+    while (carry != 0) {
+      limbs[used++] = static_cast<uint32_t>(carry % kBase58Limb);
+      carry /= kBase58Limb;
     }
-    j = k;
   }
+  if (used == 0) return zeros;
 
-  std::string result;
-  result.reserve(zeros + j);
-  for (size_t i = 0; i < zeros; ++i) result.push_back('1');
-  auto it = b58.begin();
-  while (it != b58.end() && *it == 0) ++it;
-  for (; it != b58.end(); ++it) result.push_back(BASE58_ALPHABET[*it]);
-  return result;
+  char top[5];
+  size_t n = 0;
+  for (uint32_t v = limbs[used - 1]; v != 0; v /= 58) {
+    top[n++] = BASE58_ALPHABET[v % 58];
+  }
+  while (n > 0) *p++ = top[--n];
+  for (size_t k = used - 1; k-- > 0; p += 5) {
+    uint32_t v = limbs[k];
+    for (int d = 4; d >= 0; --d, v /= 58) p[d] = BASE58_ALPHABET[v % 58];
+  }
+  return static_cast<size_t>(p - out);
 }
 
-std::string base64_encode(const unsigned char* data, size_t len) {
-  static const char* b64chars =
-      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-  std::string result;
-  result.reserve(((len + 2) / 3) * 4);
-
-  for (size_t i = 0; i < len; i += 3) {
-    unsigned int val = (data[i] << 16);
-    if (i + 1 < len) val |= (data[i + 1] << 8);
-    if (i + 2 < len) val |= data[i + 2];
+std::vector<unsigned char> hex_to_bytes(const std::string& hex) {
+  const char* s = hex.data();
+  size_t len = hex.size();
+  if (len >= 2 && s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) {
+    s += 2;
+    len -= 2;
+  }
+  if (len % 2) throw std::runtime_error("invalid hex length");
 
-    result.push_back(b64chars[(val >> 18) & 0x3F]);
-    result.push_back(b64chars[(val >> 12) & 0x3F]);
-    result.push_back((i + 1 < len) ? b64chars[(val >> 6) & 0x3F] : '=');
-    result.push_back((i + 2 < len) ? b64chars[val & 0x3F] : '=');
+  std::vector<unsigned char> out(len / 2);
+  if (!hex_decode(s, len, out.data())) {
+    throw std::runtime_error("invalid hex character");
   }
+  return out;
+}
 
+std::string bytes_to_hex(const unsigned char* data, size_t len) {
+  std::string result(hex_encoded_size(len), '\0');
+  hex_encode(data, len, &result[0]);
+  return result;
+}
+
+std::string base58_encode(const unsigned char* bytes, size_t len) {
+  std::string result(base58_encoded_max_size(len), '\0');
+  result.resize(base58_encode(bytes, len, &result[0]));
+  return result;
+}
+
+std::string base64_encode(const unsigned char* data, size_t len) {
+  std::string result(base64_encoded_size(len), '\0');
+  base64_encode(data, len, &result[0]);
   return result;
 }
 
 std::string base64url_decode(const std::string& in) {
-  std::string s = in;
-  for (char& c : s) {
-    if (c == '-')
-      c = '+';
-    else if (c == '_')
-      c = '/';
-  }
-  while (s.size() % 4) s.push_back('=');
-
-  static const std::string B64 =
-      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-  std::vector<int> T(256, -1);
-  for (int i = 0; i < 64; ++i) T[(unsigned char)B64[i]] = i;
-
-  std::string out;
-  int val = 0, valb = -8;
-  for (unsigned char c : s) {
-    if (T[c] == -1) break;
-    val = (val << 6) + T[c];
-    valb += 6;
-    if (valb >= 0) {
-      out.push_back(char((val >> valb) & 0xFF));
-      valb -= 8;
-    }
-  }
+  std::string out(base64_decoded_max_size(in.size()), '\0');
+  out.resize(base64_decode(in.data(), in.size(),
+                           reinterpret_cast<unsigned char*>(&out[0])));
   return out;
 }
 
@@ -212,9 +527,10 @@ std::string eip55_checksum_address(const unsigned char* addr_bytes,
                                    size_t len) {
   if (len != 20) throw std::runtime_error("address must be 20 bytes");
 
-  std::string addr_hex = bytes_to_hex(addr_bytes, len);
+  char addr_hex[40];
+  hex_encode(addr_bytes, len, addr_hex);
   unsigned char addr_hash[32];
-  keccak_256_impl((const unsigned char*)addr_hex.data(), addr_hex.size(),
+  keccak_256_impl((const unsigned char*)addr_hex, sizeof(addr_hex),
                   addr_hash);
 
   std::string result = "0x";
@@ -8,6 +8,12 @@ namespace standx {
 // Keccak-256 hash
 void keccak256(const unsigned char* in, size_t inlen, unsigned char* out);
 
+// Keccak-256 of count independent messages (in[i], inlen[i]) into out[i].
+// Hashes them four at a time through one interleaved permutation, which is
+// faster than one by one when several digests are needed together.
+void keccak256_multi(const unsigned char* const* in, const size_t* inlen,
+                     unsigned char* const* out, size_t count);
+
 // Convert hex string to bytes
 std::vector<unsigned char> hex_to_bytes(const std::string& hex);
 
@@ -23,6 +29,33 @@ std::string base64_encode(const unsigned char* data, size_t len);
 // Base64url decode
 std::string base64url_decode(const std::string& in);
 
+// Buffer forms of the codecs above. They write into out, which must hold
+// the matching *_size() bytes, allocate nothing and return the number of
+// bytes written. No terminator is appended.
+
+constexpr size_t hex_encoded_size(size_t len) { return 2 * len; }
+constexpr size_t base64_encoded_size(size_t len) { return (len + 2) / 3 * 4; }
+constexpr size_t base64_decoded_max_size(size_t len) { return len / 4 * 3 + 2; }
+constexpr size_t base58_encoded_max_size(size_t len) {
+  return len * 138 / 100 + 1;
+}
+
+// Lowercase hex.
+size_t hex_encode(const unsigned char* data, size_t len, char* out);
+
+// Either case, no 0x prefix; len must be even. Returns false on a
+// character that is not a hex digit.
+bool hex_decode(const char* in, size_t len, unsigned char* out);
+
+// Standard alphabet with '=' padding.
+size_t base64_encode(const unsigned char* data, size_t len, char* out);
+
+// Accepts the standard and the URL-safe alphabet, with or without
+// padding; stops at '=' or any other character outside them.
+size_t base64_decode(const char* in, size_t len, unsigned char* out);
+
+size_t base58_encode(const unsigned char* bytes, size_t len, char* out);
+
 // Generate EIP-55 checksum address from raw address bytes
 std::string eip55_checksum_address(const unsigned char* addr_bytes, size_t len);
 
@@ -1,9 +1,15 @@
 #ifndef _DATA_H
 #define _DATA_H
 
+#include <cmath>
 #include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <type_traits>
 
 #include "Poco/Timestamp.h"
+#include "crypto_utils.h"
 #include "defines.h"
 
 struct Config {
@@ -19,9 +25,33 @@ struct Config {
   std::string logName;
   std::string logSize;
   std::string logLevel;
+  bool logAsync;
+  int logAsyncRingKb;
+  std::string logAsyncOverflow;
 
   std::string barkServer;
 
+  bool journalEnable;
+  std::string journalPath;
+
+  std::string apiBaseUrl;
+  std::string authBaseUrl;
+
+  int httpPoolSize;
+  int httpIdleTimeout;
+
+  bool wsEnable;
+  std::string wsUrl;
+  bool wsOrderStream;
+  std::string wsCaLocation;
+
+  std::string strategyWaitStrategy;
+  int strategyTickIntervalMs;
+  int strategyCpu;
+  int strategyWorkers;
+
+  int signCpu;
+
   float subBtcSize;
   float subEthSize;
   float subSolSize;
@@ -32,40 +62,166 @@ struct Config {
 };
 
 extern Config kConfig;
+
+// Shape of one grid. Live trading uses the per-symbol defaults (see
+// Strategy::DefaultParams); backtests and sweeps pass their own.
+struct GridParams {
+  double order_interval{0.1};  // price distance between levels
+  double grid_size{DEFAULT_CONTRACT_SIZE};  // size of every grid order
+  int order_num{ORDER_NUM};  // place orders kept on each side
+  // Position is topped up below order_num * factor grid orders.
+  double max_order_num_factor{MAX_ORDER_NUM_FACTOR};
+  int tp_levels{5};  // TP orders start this many levels out
+  double base_price{0.0};
+};
 struct Ticker {
   std::string contract;
   float last;
 };
 
+// Order lifecycle. The first block mirrors venue states (see
+// standx::mapOrderStatus); the rest are grid bookkeeping states.
+enum class OrderStatus : uint8_t {
+  kNone,
+  kNew,
+  kPartiallyFilled,
+  kFilled,
+  kCanceled,
+  kFailed,
+  kUnknown,
+  kIdle,
+  kFilledOpenImmediate,
+  kFilledCloseWait,
+  kFilledCloseImmediate,
+};
+
+enum class OrderSide : uint8_t { kNone, kBuy, kSell };
+
+enum class OrderType : uint8_t { kLimit, kMarket };
+
+enum class PositionSide : uint8_t { kNone, kLong, kShort };
+
+inline const char* toString(OrderStatus status) {
+  switch (status) {
+    case OrderStatus::kNone: return "NONE";
+    case OrderStatus::kNew: return "NEW";
+    case OrderStatus::kPartiallyFilled: return "PARTIALLY_FILLED";
+    case OrderStatus::kFilled: return "FILLED";
+    case OrderStatus::kCanceled: return "CANCELED";
+    case OrderStatus::kFailed: return "FAILED";
+    case OrderStatus::kUnknown: return "UNKNOWN";
+    case OrderStatus::kIdle: return "IDLE";
+    case OrderStatus::kFilledOpenImmediate: return "FILLED_OPEN_IMMEDIATE";
+    case OrderStatus::kFilledCloseWait: return "FILLED_CLOSE_WAIT";
+    case OrderStatus::kFilledCloseImmediate: return "FILLED_CLOSE_IMMEDIATE";
+  }
+  return "UNKNOWN";
+}
+
+inline const char* toString(OrderSide side) {
+  return side == OrderSide::kBuy    ? "BUY"
+         : side == OrderSide::kSell ? "SELL"
+                                    : "NONE";
+}
+
+inline const char* toString(OrderType type) {
+  return type == OrderType::kMarket ? "MARKET" : "LIMIT";
+}
+
+inline const char* toString(PositionSide side) {
+  return side == PositionSide::kLong ? "LONG"
+         : side == PositionSide::kShort ? "SHORT"
+                                        : "NONE";
+}
+
+// Preferred over the generic enum printer in util.h.
+inline std::ostream& operator<<(std::ostream& os, OrderStatus v) {
+  return os << toString(v);
+}
+inline std::ostream& operator<<(std::ostream& os, OrderSide v) {
+  return os << toString(v);
+}
+inline std::ostream& operator<<(std::ostream& os, OrderType v) {
+  return os << toString(v);
+}
+inline std::ostream& operator<<(std::ostream& os, PositionSide v) {
+  return os << toString(v);
+}
+
+// Decimal with 8 fractional digits stored as an integer. Converts to and
+// from double implicitly so grid arithmetic reads as before. Compare a Fixed
+// with another Fixed: equal raws give equal doubles, a raw float may not.
+struct Fixed {
+  static constexpr int64_t kScale = 100000000;
+
+  int64_t raw{0};
+
+  Fixed() = default;
+  Fixed(double value) : raw(std::llround(value * kScale)) {}
+  operator double() const { return static_cast<double>(raw) / kScale; }
+
+  static Fixed fromRaw(int64_t raw) {
+    Fixed f;
+    f.raw = raw;
+    return f;
+  }
+};
+
+// 16 raw bytes of a UUID v4; formatted as text only when sent to the venue.
+struct ClientOrderId {
+  uint8_t bytes[16]{};
+
+  bool empty() const {
+    for (uint8_t b : bytes) {
+      if (b) return false;
+    }
+    return true;
+  }
+  bool operator==(const ClientOrderId& other) const {
+    return std::memcmp(bytes, other.bytes, sizeof(bytes)) == 0;
+  }
+  bool operator!=(const ClientOrderId& other) const {
+    return !(*this == other);
+  }
+};
+
+struct ClientOrderIdHash {
+  size_t operator()(const ClientOrderId& id) const {
+    uint64_t lo;
+    uint64_t hi;
+    std::memcpy(&lo, id.bytes, sizeof(lo));
+    std::memcpy(&hi, id.bytes + sizeof(lo), sizeof(hi));
+    return static_cast<size_t>(lo ^ (hi * 0x9E3779B97F4A7C15ULL));
+  }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const ClientOrderId& id) {
+  char text[standx::hex_encoded_size(sizeof(id.bytes))];
+  return os.write(text, standx::hex_encode(id.bytes, sizeof(id.bytes), text));
+}
+
+// Plain value type: copying an order never allocates.
 struct Order {
+  int64_t id{0};
+  int64_t tpId{0};
+  ClientOrderId clientId;
+  ClientOrderId tpClientId;
+  Fixed price;
+  Fixed tp_price;
+  Fixed size;
+  OrderStatus status{OrderStatus::kNone};
+  OrderSide side{OrderSide::kNone};
+  OrderType type{OrderType::kLimit};
+  PositionSide positionSide{PositionSide::kNone};
   bool is_reduce_only{false};
-  float size{0.0};
-  float last_close_pnl;
-  float price{0.0};
-  float tp_price{0.0};
-  float sl_price{0.0};
-  int rule;
-
-  std::string contract;
-  std::string id;
-  std::string tpId;
-  std::string slId;
-  std::string side;
-  std::string fill_price;
-  std::string auto_size;
-  std::string trigger_price;
-
-  std::string startTime;
-  std::string endTime;
-  std::string status;  // NEW FILLED IDLE
-
-  std::string positionSide;
-  std::string type;
 };
 
+static_assert(std::is_trivially_copyable<Order>::value,
+              "Order must stay a plain value type");
+
 struct Position {
-  std::string positionSide;
-  float positionAmt;
+  PositionSide positionSide{PositionSide::kNone};
+  float positionAmt{0.0};
 };
 
 struct Contract {
@@ -6,5 +6,7 @@
 #define MAX_ORDER_NUM_FACTOR 1.5
 #define PRICE_ACCURACY_INT 2
 #define PRICE_ACCURACY_FLOAT 0.01
+#define MAX_QUOTE_AGE_MS 2000
+#define MAX_BATCH_CANCEL 50
 
 #endif
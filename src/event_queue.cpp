@@ -0,0 +1,101 @@
+#include "event_queue.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CPU_RELAX() _mm_pause()
+#else
+#define CPU_RELAX() std::this_thread::yield()
+#endif
+
+namespace standx {
+
+std::unique_ptr<WaitStrategy> WaitStrategy::create(const std::string& name) {
+  if (name == "spin_park") return std::make_unique<SpinThenParkWaitStrategy>();
+  if (name == "busy") return std::make_unique<BusySpinWaitStrategy>();
+  return std::make_unique<BlockingWaitStrategy>();
+}
+
+void BlockingWaitStrategy::wait(const std::atomic<uint32_t>& pending,
+                                std::chrono::steady_clock::time_point deadline) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cond_.wait_until(lock, deadline, [&pending]() {
+    return pending.load(std::memory_order_acquire) != 0;
+  });
+}
+
+void BlockingWaitStrategy::notify() {
+  // Taking the lock orders the notify after a concurrent predicate check.
+  { std::lock_guard<std::mutex> lock(mutex_); }
+  cond_.notify_one();
+}
+
+void SpinThenParkWaitStrategy::wait(
+    const std::atomic<uint32_t>& pending,
+    std::chrono::steady_clock::time_point deadline) {
+  auto spin_until = std::min(deadline, std::chrono::steady_clock::now() + spin_);
+  while (std::chrono::steady_clock::now() < spin_until) {
+    if (pending.load(std::memory_order_acquire) != 0) return;
+    CPU_RELAX();
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  // Store parked_ then load pending, while post() does the reverse; with
+  // all four seq_cst at least one side sees the other's write, so a post
+  // racing the park either is seen here or wakes us.
+  parked_.store(true, std::memory_order_seq_cst);
+  cond_.wait_until(lock, deadline, [&pending]() {
+    return pending.load(std::memory_order_seq_cst) != 0;
+  });
+  parked_.store(false, std::memory_order_relaxed);
+}
+
+void SpinThenParkWaitStrategy::notify() {
+  // Producers only pay for the lock when the consumer is actually parked.
+  if (!parked_.load(std::memory_order_seq_cst)) return;
+  { std::lock_guard<std::mutex> lock(mutex_); }
+  cond_.notify_one();
+}
+
+void BusySpinWaitStrategy::wait(const std::atomic<uint32_t>& pending,
+                                std::chrono::steady_clock::time_point deadline) {
+  while (pending.load(std::memory_order_acquire) == 0) {
+    if (std::chrono::steady_clock::now() >= deadline) return;
+    CPU_RELAX();
+  }
+}
+
+EventQueue::EventQueue(std::unique_ptr<WaitStrategy> wait_strategy)
+    : wait_strategy_(std::move(wait_strategy)) {}
+
+void EventQueue::post(uint32_t events) {
+  pending_.fetch_or(events, std::memory_order_seq_cst);
+  wait_strategy_->notify();
+}
+
+uint32_t EventQueue::wait(std::chrono::milliseconds timeout) {
+  uint32_t events = pending_.exchange(0, std::memory_order_acq_rel);
+  if (events != 0) return events;
+
+  wait_strategy_->wait(pending_, std::chrono::steady_clock::now() + timeout);
+  events = pending_.exchange(0, std::memory_order_acq_rel);
+  return events != 0 ? events : static_cast<uint32_t>(kEventTimer);
+}
+
+bool pinCurrentThread(int cpu) {
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  (void)cpu;
+  return false;
+#endif
+}
+
+}  // namespace standx
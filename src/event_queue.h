@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace standx {
+
+// Events that wake a strategy. They are bit flags: several posts of the same
+// kind before the consumer wakes up coalesce into one.
+enum StrategyEvent : uint32_t {
+    kEventNone = 0,
+    kEventPriceChanged = 1u << 0,
+    kEventOrderUpdate = 1u << 1,
+    kEventTimer = 1u << 2,
+    kEventShutdown = 1u << 3,
+};
+
+// How the consumer waits for the next event: trades wake-up latency for CPU.
+class WaitStrategy {
+public:
+    virtual ~WaitStrategy() = default;
+
+    // Block until pending is non-zero or the deadline passes.
+    virtual void wait(const std::atomic<uint32_t>& pending,
+                      std::chrono::steady_clock::time_point deadline) = 0;
+
+    // Called by producers after setting a bit in pending.
+    virtual void notify() = 0;
+
+    virtual const char* name() const = 0;
+
+    // "block", "spin_park" or "busy"; unknown names fall back to "block".
+    static std::unique_ptr<WaitStrategy> create(const std::string& name);
+};
+
+// Condition variable: no CPU while idle, wake-up costs a futex round-trip.
+class BlockingWaitStrategy : public WaitStrategy {
+public:
+    void wait(const std::atomic<uint32_t>& pending,
+              std::chrono::steady_clock::time_point deadline) override;
+    void notify() override;
+    const char* name() const override { return "block"; }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cond_;
+};
+
+// Spin for a short budget to catch bursts, then park on a condition variable.
+class SpinThenParkWaitStrategy : public WaitStrategy {
+public:
+    explicit SpinThenParkWaitStrategy(std::chrono::microseconds spin = std::chrono::microseconds(50))
+        : spin_(spin) {}
+    void wait(const std::atomic<uint32_t>& pending,
+              std::chrono::steady_clock::time_point deadline) override;
+    void notify() override;
+    const char* name() const override { return "spin_park"; }
+
+private:
+    std::chrono::microseconds spin_;
+    std::atomic<bool> parked_{false};
+    std::mutex mutex_;
+    std::condition_variable cond_;
+};
+
+// Never sleeps; lowest latency, burns a whole core. Pair with a pinned CPU.
+class BusySpinWaitStrategy : public WaitStrategy {
+public:
+    void wait(const std::atomic<uint32_t>& pending,
+              std::chrono::steady_clock::time_point deadline) override;
+    void notify() override {}
+    const char* name() const override { return "busy"; }
+};
+
+// Multi-producer, single-consumer queue of coalesced StrategyEvent flags.
+class EventQueue {
+public:
+    explicit EventQueue(std::unique_ptr<WaitStrategy> wait_strategy);
+
+    void post(uint32_t events);
+
+    // Wait up to timeout for events and return (and clear) all pending ones.
+    // Returns kEventTimer when the timeout expires with nothing pending.
+    uint32_t wait(std::chrono::milliseconds timeout);
+
+    // Return (and clear) all pending events without waiting; for consumers
+    // that are scheduled from outside, like StrategyHost.
+    uint32_t poll() { return pending_.exchange(0, std::memory_order_acq_rel); }
+
+    bool has_pending() const {
+        return pending_.load(std::memory_order_seq_cst) != 0;
+    }
+
+    const char* wait_strategy() const { return wait_strategy_->name(); }
+
+private:
+    std::atomic<uint32_t> pending_{0};
+    std::unique_ptr<WaitStrategy> wait_strategy_;
+};
+
+// Pin the calling thread to one CPU; false if the platform refuses.
+bool pinCurrentThread(int cpu);
+
+}  // namespace standx
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "data.h"
+
+namespace standx {
+
+// Outcome of an amend. kRejected leaves the old order untouched;
+// kReplaceFailed means it was cancelled but the new one was not placed.
+enum class AmendStatus : uint8_t { kAmended, kRejected, kReplaceFailed };
+
+// What a Strategy needs from a venue for one symbol. StandXClient talks to
+// the live API; SimExchange matches against replayed prices.
+class Exchange {
+public:
+    virtual ~Exchange() = default;
+
+    virtual std::string getInstId() const = 0;
+
+    virtual bool positions(std::vector<Position>& positions_list) = 0;
+    virtual bool tickers(Ticker& tk) = 0;
+    virtual bool balance(float& availBal, float& totalBal) = 0;
+
+    // Fill order.status from order.id.
+    virtual bool detail(Order& order) = 0;
+    // Fill order.id and order.status from order.clientId.
+    virtual bool detailByClientId(Order& order) = 0;
+    // The same without blocking; order must outlive the future.
+    virtual std::future<bool> detailByClientIdAsync(Order& order) = 0;
+    // order_list is cleared and refilled.
+    virtual bool unfilledOrders(std::vector<Order>& order_list) = 0;
+
+    // Placement assigns order.clientId (tpClientId for a TP); the result
+    // says whether the venue accepted the request, not whether it rests.
+    virtual bool placeOrder(Order& order) = 0;
+    virtual std::future<bool> placeOrderAsync(Order& order) = 0;
+    virtual std::future<bool> tpOrderAsync(Order& order) = 0;
+    virtual std::future<AmendStatus> amendOrderAsync(int64_t id, Order& order,
+                                                     bool tp) = 0;
+    // results[i] is for ids[i], true once that order is cancelled. Ids
+    // found to have filled instead are appended to filled when given.
+    virtual std::vector<bool> cancelOrders(
+        const std::vector<int64_t>& ids,
+        std::vector<int64_t>* filled = nullptr) = 0;
+
+    // Give the venue time to settle, e.g. after a market order. Simulated
+    // venues settle instantly and return at once.
+    virtual void sleep(int ms) = 0;
+};
+
+}  // namespace standx
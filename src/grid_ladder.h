@@ -0,0 +1,145 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+
+namespace standx {
+
+// Grid levels keyed by integer tick (price / order_interval) in a fixed ring
+// of N slots. A tick lives in slot (tick & (N - 1)) and the slot remembers
+// its tick, so lookups, inserts and erases are a mask and a compare.
+//
+// The ring covers the window [center - N/2, center + N/2). Levels outside
+// it live in an ordered overflow map instead, so a level with an order or
+// position still attached is never lost when the price runs away from it:
+// recenter() moves the levels leaving the window into the overflow (or
+// drops them, if the caller says they are idle) and pulls the ones coming
+// back into the ring. find(), insert() and erase() reach both.
+template <typename T, size_t N = 256>
+class GridLadder {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be a power of two");
+
+public:
+    static constexpr int64_t kHalfWindow = static_cast<int64_t>(N / 2);
+
+    using Overflow = std::map<int64_t, T>;
+
+    // Moves the window to center. keep(tick, level) decides whether a level
+    // leaving the window goes to the overflow (true) or is dropped.
+    template <typename Keep>
+    void recenter(int64_t center, Keep&& keep) {
+        if (center == center_) return;
+        const int64_t old_first = first_tick();
+        const int64_t old_last = last_tick();
+        center_ = center;
+
+        // Only the ticks that left the window can hold a slot now outside
+        // it; a jump of a window or more empties the whole ring.
+        if (center_ - (old_first + kHalfWindow) >= static_cast<int64_t>(N) ||
+            (old_first + kHalfWindow) - center_ >= static_cast<int64_t>(N)) {
+            for (auto& slot : slots_) evict(slot, keep);
+        } else if (old_first < first_tick()) {
+            for (int64_t tick = old_first; tick < first_tick(); ++tick) {
+                evict(slot_for(tick), keep);
+            }
+        } else {
+            for (int64_t tick = last_tick() + 1; tick <= old_last; ++tick) {
+                evict(slot_for(tick), keep);
+            }
+        }
+
+        // Levels the window has come back to.
+        auto it = overflow_.lower_bound(first_tick());
+        while (it != overflow_.end() && it->first <= last_tick()) {
+            Slot& slot = slot_for(it->first);
+            slot.tick = it->first;
+            slot.used = true;
+            slot.value = std::move(it->second);
+            it = overflow_.erase(it);
+        }
+    }
+
+    void recenter(int64_t center) {
+        recenter(center, [](int64_t, const T&) { return true; });
+    }
+
+    int64_t center() const { return center_; }
+
+    // Inclusive bounds of the window, for ordered scans.
+    int64_t first_tick() const { return center_ - kHalfWindow; }
+    int64_t last_tick() const { return center_ + kHalfWindow - 1; }
+
+    bool in_window(int64_t tick) const {
+        return tick >= first_tick() && tick <= last_tick();
+    }
+
+    T* find(int64_t tick) {
+        if (!in_window(tick)) {
+            auto it = overflow_.find(tick);
+            return it == overflow_.end() ? nullptr : &it->second;
+        }
+        Slot& slot = slot_for(tick);
+        return (slot.used && slot.tick == tick) ? &slot.value : nullptr;
+    }
+
+    const T* find(int64_t tick) const {
+        return const_cast<GridLadder*>(this)->find(tick);
+    }
+
+    // Store value at tick, replacing the level there if any.
+    T* insert(int64_t tick, const T& value) {
+        if (!in_window(tick)) return &(overflow_[tick] = value);
+        Slot& slot = slot_for(tick);
+        slot.tick = tick;
+        slot.used = true;
+        slot.value = value;
+        return &slot.value;
+    }
+
+    void erase(int64_t tick) {
+        if (!in_window(tick)) {
+            overflow_.erase(tick);
+            return;
+        }
+        Slot& slot = slot_for(tick);
+        if (slot.used && slot.tick == tick) slot.used = false;
+    }
+
+    // Levels outside the window, by tick. Scans that erase while iterating
+    // must advance past the level first.
+    const Overflow& overflow() const { return overflow_; }
+
+    void clear() {
+        for (auto& slot : slots_) slot.used = false;
+        overflow_.clear();
+    }
+
+private:
+    struct Slot {
+        int64_t tick{0};
+        bool used{false};
+        T value{};
+    };
+
+    static size_t index(int64_t tick) {
+        return static_cast<size_t>(static_cast<uint64_t>(tick) & (N - 1));
+    }
+    Slot& slot_for(int64_t tick) { return slots_[index(tick)]; }
+
+    template <typename Keep>
+    void evict(Slot& slot, Keep& keep) {
+        if (!slot.used || in_window(slot.tick)) return;
+        slot.used = false;
+        if (keep(slot.tick, static_cast<const T&>(slot.value))) {
+            overflow_[slot.tick] = std::move(slot.value);
+        }
+    }
+
+    int64_t center_{0};
+    std::array<Slot, N> slots_{};
+    Overflow overflow_;
+};
+
+}  // namespace standx
@@ -0,0 +1,92 @@
+#include "grid_reconciler.h"
+
+#include <algorithm>
+
+namespace standx {
+
+namespace {
+
+bool sameKind(const Order& live, const DesiredOrder& desired) {
+  return live.positionSide == desired.order.positionSide &&
+         live.is_reduce_only == desired.reduce_only();
+}
+
+}  // namespace
+
+void GridReconciler::reset() {
+  desired_.clear();
+  bands_.clear();
+}
+
+void GridReconciler::want(const DesiredOrder& desired) {
+  if (desired.intent == GridIntent::kTakeProfit) {
+    desired_.push_back(desired);
+    return;
+  }
+  for (const auto& d : desired_) {
+    if (d.tick == desired.tick &&
+        d.order.positionSide == desired.order.positionSide &&
+        d.reduce_only() == desired.reduce_only()) {
+      return;
+    }
+  }
+  desired_.push_back(desired);
+}
+
+void GridReconciler::keep(const KeepBand& band) { bands_.push_back(band); }
+
+GridActions GridReconciler::diff(const OrderBook& book) const {
+  GridActions actions;
+
+  book.for_each([&](const Order& live) {
+    int64_t tick = book.tick_of(live);
+    for (const auto& band : bands_) {
+      if (live.positionSide == band.position_side &&
+          live.is_reduce_only == band.reduce_only && live.size == band.size &&
+          (tick < band.lo_tick || tick > band.hi_tick)) {
+        actions.cancel.push_back(live);
+        break;
+      }
+    }
+  });
+
+  for (const auto& desired : desired_) {
+    if (desired.replaces != 0) {
+      AmendAction amend;
+      amend.target = desired;
+      if (const Order* live = book.find(desired.replaces)) {
+        amend.live = *live;
+      } else {
+        // Not in the last snapshot yet; the id alone is enough to cancel it.
+        amend.live.id = desired.replaces;
+        amend.live.positionSide = desired.order.positionSide;
+        amend.live.is_reduce_only = desired.reduce_only();
+      }
+      auto replaced = [&](const Order& o) { return o.id == desired.replaces; };
+      actions.cancel.erase(std::remove_if(actions.cancel.begin(),
+                                          actions.cancel.end(), replaced),
+                           actions.cancel.end());
+      actions.amend.push_back(amend);
+      continue;
+    }
+
+    if (desired.intent != GridIntent::kTakeProfit &&
+        book.contains(desired.order.positionSide, desired.reduce_only(),
+                      desired.tick)) {
+      continue;
+    }
+
+    auto spare = std::find_if(
+        actions.cancel.begin(), actions.cancel.end(),
+        [&](const Order& live) { return sameKind(live, desired); });
+    if (spare != actions.cancel.end()) {
+      actions.amend.push_back(AmendAction{*spare, desired});
+      actions.cancel.erase(spare);
+    } else {
+      actions.place.push_back(desired);
+    }
+  }
+  return actions;
+}
+
+}  // namespace standx
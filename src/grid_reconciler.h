@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "data.h"
+#include "order_book.h"
+
+namespace standx {
+
+// Why the grid wants an order; decides how a placed order is written back
+// into the ladder.
+enum class GridIntent : uint8_t {
+    kOpen,        // place order for an idle level
+    kTakeProfit,  // TP for a level whose place order filled (or a reprice)
+    kCover,       // extra TP covering position not yet reduced
+};
+
+// One order the grid wants resting on the book.
+struct DesiredOrder {
+    Order order;            // side, positionSide, type, size, price / tp_price
+    int64_t tick{0};        // price tick the order rests at
+    int64_t level_tick{0};  // ladder level the order belongs to
+    int64_t replaces{0};    // live order id this one supersedes, if any
+    GridIntent intent{GridIntent::kOpen};
+
+    bool reduce_only() const { return intent != GridIntent::kOpen; }
+};
+
+// Live grid orders of one kind (position side + reduce-only, of exactly the
+// grid size) may rest anywhere in [lo_tick, hi_tick]; the rest are cancelled.
+struct KeepBand {
+    PositionSide position_side{PositionSide::kNone};
+    bool reduce_only{false};
+    int64_t lo_tick{INT64_MIN};
+    int64_t hi_tick{INT64_MAX};
+    Fixed size;
+};
+
+// A live order to be moved to a desired price instead of cancel + place.
+struct AmendAction {
+    Order live;
+    DesiredOrder target;
+};
+
+struct GridActions {
+    std::vector<Order> cancel;
+    std::vector<DesiredOrder> place;
+    std::vector<AmendAction> amend;
+
+    bool empty() const {
+        return cancel.empty() && place.empty() && amend.empty();
+    }
+};
+
+// Collects one tick's desired order set and diffs it against the live book
+// into a minimal set of cancel / place / amend actions.
+class GridReconciler {
+public:
+    // Start a new tick; keeps buffer capacity.
+    void reset();
+
+    // Add a desired order. Open and cover orders are unique per kind and
+    // tick (a repeat is dropped); take-profits are not, since several filled
+    // levels may share one TP price.
+    void want(const DesiredOrder& desired);
+
+    void keep(const KeepBand& band);
+
+    // Open and cover orders already live are left alone; live orders outside
+    // their band are cancelled; a cancel and a place of the same kind are
+    // paired into an amend.
+    GridActions diff(const OrderBook& book) const;
+
+    size_t wanted() const { return desired_.size(); }
+
+private:
+    std::vector<DesiredOrder> desired_;
+    std::vector<KeepBand> bands_;
+};
+
+}  // namespace standx
@@ -5,19 +5,15 @@
 #include <iostream>
 #include <stdexcept>
 
+#include "connection_pool.h"
+#include "latency.h"
 #include "tracer.h"
 
 namespace standx {
 
-HttpClient::HttpClient() {
-  curl_ = curl_easy_init();
-  if (!curl_) throw std::runtime_error("curl init failed");
-  last_response_code_ = 0;
-}
+HttpClient::HttpClient() : last_response_code_(0) {}
 
-HttpClient::~HttpClient() {
-  if (curl_) curl_easy_cleanup((CURL*)curl_);
-}
+HttpClient::~HttpClient() = default;
 
 void HttpClient::set_token_refresh_callback(TokenRefreshCallback callback) {
   token_refresh_callback_ = callback;
@@ -34,8 +30,10 @@ std::string HttpClient::perform_request_internal(const std::string& url,
                                                  const std::string& method,
                                                  const std::string& post_data,
                                                  bool retry_on_401) {
-  CURL* curl = (CURL*)curl_;
-  curl_easy_reset(curl);
+  // Pooled handles keep their connection alive between calls, so every
+  // per-request option is set explicitly instead of curl_easy_reset().
+  ConnectionPool& pool = ConnectionPool::instance();
+  CURL* curl = (CURL*)pool.acquire(url);
 
   struct curl_slist* headers = (struct curl_slist*)headers_ptr;
 
@@ -44,20 +42,30 @@ std::string HttpClient::perform_request_internal(const std::string& url,
   curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
   curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
   curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-
-  if (!method.empty()) {
-    curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, method.c_str());
-  }
+  curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST,
+                   method.empty() ? nullptr : method.c_str());
 
   if (!post_data.empty()) {
     curl_easy_setopt(curl, CURLOPT_POSTFIELDS, post_data.c_str());
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, (long)post_data.size());
+  } else {
+    curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
   }
 
   INFO_("api", "send " << method << " " << url << ", body:" << post_data);
+  int64_t sent_ns = monoNowNs();
   CURLcode res = curl_easy_perform(curl);
+  endpointLatency(method, url).record(monoNowNs() - sent_ns);
   INFO_("api", "response: " << response);
 
-  curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &last_response_code_);
+  long response_code = 0;
+  curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
+  last_response_code_ = response_code;
+
+  // Detach request-scoped pointers before the handle goes back to the pool.
+  curl_easy_setopt(curl, CURLOPT_HTTPHEADER, nullptr);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, nullptr);
+  pool.release(url, curl, res == CURLE_OK);
 
   curl_slist_free_all(headers);
 
@@ -66,7 +74,7 @@ std::string HttpClient::perform_request_internal(const std::string& url,
                              std::string(curl_easy_strerror(res)));
   }
 
-  if (retry_on_401 && last_response_code_ == 401 && token_refresh_callback_) {
+  if (retry_on_401 && response_code == 401 && token_refresh_callback_) {
     std::string new_token = token_refresh_callback_();
 
     struct curl_slist* new_headers = nullptr;
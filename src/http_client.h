@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <map>
 #include <functional>
@@ -42,8 +43,9 @@ private:
     static size_t write_callback(void* contents, size_t size, size_t nmemb, void* userp);
     std::string perform_request(const std::string& url, void* headers, const std::string& method = "", const std::string& post_data = "");
     std::string perform_request_internal(const std::string& url, void* headers, const std::string& method, const std::string& post_data, bool retry_on_401);
-    void* curl_;
-    long last_response_code_;
+    // Shared by every strategy using the session, so requests run
+    // concurrently; each one works on its own copy of the code.
+    std::atomic<long> last_response_code_;
     TokenRefreshCallback token_refresh_callback_;
 };
 
@@ -0,0 +1,263 @@
+#include "journal.h"
+
+#include <fcntl.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+namespace standx {
+
+static_assert(sizeof(JournalRecord) == kJournalRecordSize,
+              "JournalRecord must match the on-disk record layout");
+static_assert(offsetof(JournalRecord, symbol) == 48 &&
+                  offsetof(JournalRecord, event) == 60,
+              "JournalRecord must match the on-disk record layout");
+
+namespace {
+
+// Indexed by JournalEvent.
+const char* const kEventNames[] = {"none",   "price", "position",
+                                   "place",  "reject", "fill",
+                                   "cancel", "cancel_failed"};
+static_assert(sizeof(kEventNames) / sizeof(kEventNames[0]) ==
+                  kJournalEventCount,
+              "every JournalEvent needs a name");
+
+void encode(const JournalRecord& record, char* out) {
+  putLE(record.seq, out);
+  putLE(static_cast<uint64_t>(record.ts_us), out + 8);
+  putLE(static_cast<uint64_t>(record.order_id), out + 16);
+  putLE(static_cast<uint64_t>(record.price), out + 24);
+  putLE(static_cast<uint64_t>(record.size), out + 32);
+  putLE(static_cast<uint64_t>(record.aux), out + 40);
+  std::memcpy(out + 48, record.symbol, sizeof(record.symbol));
+  out[60] = static_cast<char>(record.event);
+  out[61] = static_cast<char>(record.side);
+  out[62] = static_cast<char>(record.position_side);
+  out[63] = static_cast<char>(record.flags);
+}
+
+void decode(const char* in, JournalRecord& record) {
+  record.seq = getLE(in);
+  record.ts_us = static_cast<int64_t>(getLE(in + 8));
+  record.order_id = static_cast<int64_t>(getLE(in + 16));
+  record.price = static_cast<int64_t>(getLE(in + 24));
+  record.size = static_cast<int64_t>(getLE(in + 32));
+  record.aux = static_cast<int64_t>(getLE(in + 40));
+  std::memcpy(record.symbol, in + 48, sizeof(record.symbol));
+  record.event = static_cast<JournalEvent>(in[60]);
+  record.side = static_cast<OrderSide>(in[61]);
+  record.position_side = static_cast<PositionSide>(in[62]);
+  record.flags = static_cast<uint8_t>(in[63]);
+}
+
+bool checkHeader(const char* header) {
+  return std::memcmp(header, kJournalMagic, sizeof(kJournalMagic)) == 0 &&
+         getLE(header + 8) == kJournalRecordSize;
+}
+
+void setSymbol(JournalRecord& record, const std::string& symbol) {
+  size_t n = std::min(symbol.size(), sizeof(record.symbol));
+  std::memcpy(record.symbol, symbol.data(), n);
+}
+
+bool writeAll(int fd, const char* data, size_t size) {
+  while (size > 0) {
+    ssize_t n = ::write(fd, data, size);
+    if (n < 0) return false;
+    data += n;
+    size -= static_cast<size_t>(n);
+  }
+  return true;
+}
+
+}  // namespace
+
+const char* toString(JournalEvent event) {
+  size_t index = static_cast<size_t>(event);
+  return index < kJournalEventCount
+             ? kEventNames[index]
+             : "unknown";
+}
+
+bool parseJournalEvent(const std::string& name, JournalEvent& event) {
+  for (size_t i = 1; i < kJournalEventCount; ++i) {
+    if (strcasecmp(name.c_str(), kEventNames[i]) == 0) {
+      event = static_cast<JournalEvent>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string JournalRecord::symbolName() const {
+  return std::string(symbol, strnlen(symbol, sizeof(symbol)));
+}
+
+Journal& Journal::instance() {
+  static Journal journal;
+  return journal;
+}
+
+Journal::~Journal() { close(); }
+
+bool Journal::open(const std::string& path, std::string& error) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (fd_ >= 0) {
+    flushLocked();
+    ::close(fd_);
+    fd_ = -1;
+    open_ = false;
+  }
+
+  int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+  if (fd < 0) {
+    error = "cannot open " + path;
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    ::close(fd);
+    error = "cannot stat " + path;
+    return false;
+  }
+
+  uint64_t next_seq = 1;
+  size_t size = static_cast<size_t>(st.st_size);
+  if (size == 0) {
+    char header[kJournalHeaderSize] = {};
+    std::memcpy(header, kJournalMagic, sizeof(kJournalMagic));
+    header[8] = static_cast<char>(kJournalRecordSize);
+    if (!writeAll(fd, header, sizeof(header))) {
+      ::close(fd);
+      error = "write failed: " + path;
+      return false;
+    }
+  } else {
+    char header[kJournalHeaderSize];
+    if (size < kJournalHeaderSize ||
+        pread(fd, header, sizeof(header), 0) !=
+            static_cast<ssize_t>(sizeof(header)) ||
+        !checkHeader(header)) {
+      ::close(fd);
+      error = path + ": not a journal file";
+      return false;
+    }
+    size_t count = (size - kJournalHeaderSize) / kJournalRecordSize;
+    size_t whole = kJournalHeaderSize + count * kJournalRecordSize;
+    if (whole != size && ftruncate(fd, static_cast<off_t>(whole)) != 0) {
+      ::close(fd);
+      error = "cannot drop partial record: " + path;
+      return false;
+    }
+    if (count > 0) {
+      char last[kJournalRecordSize];
+      if (pread(fd, last, sizeof(last),
+                static_cast<off_t>(whole - kJournalRecordSize)) !=
+          static_cast<ssize_t>(sizeof(last))) {
+        ::close(fd);
+        error = "read failed: " + path;
+        return false;
+      }
+      JournalRecord record;
+      decode(last, record);
+      next_seq = record.seq + 1;
+    }
+  }
+
+  fd_ = fd;
+  path_ = path;
+  next_seq_ = next_seq;
+  buffer_.clear();
+  buffer_.reserve(kBufferRecords * kJournalRecordSize);
+  open_ = true;
+  return true;
+}
+
+void Journal::close() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (fd_ < 0) return;
+  flushLocked();
+  ::close(fd_);
+  fd_ = -1;
+  open_ = false;
+}
+
+bool Journal::isOpen() const { return open_.load(std::memory_order_acquire); }
+
+void Journal::flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  flushLocked();
+}
+
+void Journal::flushLocked() {
+  if (fd_ < 0 || buffer_.empty()) return;
+  if (!writeAll(fd_, buffer_.data(), buffer_.size())) {
+    perror(("journal write failed: " + path_).c_str());
+  }
+  buffer_.clear();
+}
+
+void Journal::append(JournalRecord& record) {
+  if (!isOpen()) return;
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (fd_ < 0) return;
+  record.seq = next_seq_++;
+  record.ts_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                     std::chrono::system_clock::now().time_since_epoch())
+                     .count();
+  size_t offset = buffer_.size();
+  buffer_.resize(offset + kJournalRecordSize);
+  encode(record, buffer_.data() + offset);
+  if (buffer_.size() >= kBufferRecords * kJournalRecordSize) flushLocked();
+}
+
+void Journal::order(JournalEvent event, const std::string& symbol,
+                    const Order& order, int64_t aux) {
+  if (!isOpen()) return;
+  JournalRecord record;
+  record.event = event;
+  setSymbol(record, symbol);
+  record.order_id = order.id;
+  record.price = order.price.raw;
+  record.size = order.size.raw;
+  record.aux = aux;
+  record.side = order.side;
+  record.position_side = order.positionSide;
+  record.flags = order.is_reduce_only ? kJournalReduceOnly : 0;
+  append(record);
+}
+
+void Journal::price(const std::string& symbol, double price) {
+  if (!isOpen()) return;
+  JournalRecord record;
+  record.event = JournalEvent::kPrice;
+  setSymbol(record, symbol);
+  record.price = Fixed(price).raw;
+  append(record);
+}
+
+void Journal::position(const std::string& symbol, const Position& position) {
+  if (!isOpen()) return;
+  JournalRecord record;
+  record.event = JournalEvent::kPosition;
+  setSymbol(record, symbol);
+  record.position_side = position.positionSide;
+  record.size = Fixed(position.positionAmt).raw;
+  record.aux = position.positionSide == PositionSide::kShort ? -record.size
+                                                             : record.size;
+  append(record);
+}
+
+bool MappedJournal::open(const std::string& path, std::string& error) {
+  return records_.open(path, kJournalHeaderSize, checkHeader, decode,
+                       "journal file", error);
+}
+
+}  // namespace standx
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "data.h"
+#include "mapped_file.h"
+
+namespace standx {
+
+// What a journal record describes.
+enum class JournalEvent : uint8_t {
+    kNone = 0,
+    kPrice = 1,     // price a grid step worked from
+    kPosition = 2,  // position size changed; aux is the signed amount
+    kPlace = 3,     // order accepted by the exchange
+    kReject = 4,    // order placement failed
+    kFill = 5,      // order seen fully filled
+    kCancel = 6,    // order cancelled by the strategy (or an amend)
+    kCancelFailed = 7,
+};
+
+// Number of JournalEvent values, kNone included; keep it one past the last.
+constexpr size_t kJournalEventCount =
+    static_cast<size_t>(JournalEvent::kCancelFailed) + 1;
+
+const char* toString(JournalEvent event);
+// Accepts the names toString returns, case-insensitively.
+bool parseJournalEvent(const std::string& name, JournalEvent& event);
+
+constexpr uint8_t kJournalReduceOnly = 1;
+
+// One fixed-size journal record. Prices and sizes are Fixed raw values
+// (1e-8 units).
+struct JournalRecord {
+    uint64_t seq{0};     // 1, 2, 3... without gaps over the whole file
+    int64_t ts_us{0};    // wall clock, us since epoch
+    int64_t order_id{0};
+    int64_t price{0};
+    int64_t size{0};
+    int64_t aux{0};      // kPosition: signed size; TP orders: level price
+    char symbol[12]{};   // NUL padded
+    JournalEvent event{JournalEvent::kNone};
+    OrderSide side{OrderSide::kNone};
+    PositionSide position_side{PositionSide::kNone};
+    uint8_t flags{0};    // kJournalReduceOnly
+
+    std::string symbolName() const;
+};
+
+// Journal file: the 8-byte magic "SXJRNL1\0", uint32 record size (64) and
+// uint32 zero padding, then packed little-endian JournalRecords. Only
+// appended to, so a crash can at worst leave a partial last record, which
+// the next open cuts off.
+constexpr char kJournalMagic[8] = {'S', 'X', 'J', 'R', 'N', 'L', '1', '\0'};
+constexpr size_t kJournalHeaderSize = 16;
+constexpr size_t kJournalRecordSize = 64;
+
+// Process-wide trade journal. Strategies on any thread append; records are
+// buffered and written out by flush() (main calls it every second) or when
+// the buffer fills. Until open() succeeds every call is a no-op, so the
+// offline tools run without one.
+class Journal {
+public:
+    static Journal& instance();
+
+    // Opens or creates path and continues its sequence numbers.
+    bool open(const std::string& path, std::string& error);
+    void close();
+    bool isOpen() const;
+
+    void flush();
+
+    // Stamps seq and ts_us and queues the record.
+    void append(JournalRecord& record);
+
+    void order(JournalEvent event, const std::string& symbol,
+               const Order& order, int64_t aux = 0);
+    void price(const std::string& symbol, double price);
+    void position(const std::string& symbol, const Position& position);
+
+private:
+    static constexpr size_t kBufferRecords = 256;
+
+    Journal() = default;
+    ~Journal();
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    void flushLocked();
+
+    mutable std::mutex mutex_;
+    int fd_{-1};
+    // fd_ >= 0, readable without the lock so a closed journal (the offline
+    // tools) costs the appenders no lock.
+    std::atomic<bool> open_{false};
+    std::string path_;
+    uint64_t next_seq_{1};
+    std::vector<char> buffer_;
+};
+
+// Read-only memory mapping of a journal file, used in place on
+// little-endian hosts.
+class MappedJournal {
+public:
+    bool open(const std::string& path, std::string& error);
+
+    const JournalRecord* data() const { return records_.data(); }
+    size_t size() const { return records_.size(); }
+
+private:
+    MappedRecords<JournalRecord> records_;
+};
+
+}  // namespace standx
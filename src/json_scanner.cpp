@@ -0,0 +1,118 @@
+#include "json_scanner.h"
+
+#include <charconv>
+#include <cstring>
+
+namespace standx {
+
+JsonScanner::Type JsonScanner::peek() {
+  skipSpace();
+  if (p_ == end_) return Type::kEnd;
+  switch (*p_) {
+    case '{': return Type::kObject;
+    case '[': return Type::kArray;
+    case '"': return Type::kString;
+    case 't':
+    case 'f': return Type::kBool;
+    case 'n': return Type::kNull;
+    default: return Type::kNumber;
+  }
+}
+
+bool JsonScanner::string(std::string_view& out) {
+  if (failed_ || !consume('"')) return fail();
+  const char* begin = p_;
+  while (p_ < end_) {
+    const char* quote = static_cast<const char*>(
+        memchr(p_, '"', static_cast<size_t>(end_ - p_)));
+    if (quote == nullptr) break;
+    // The quote is escaped when an odd number of backslashes precede it.
+    const char* q = quote;
+    while (q > begin && q[-1] == '\\') --q;
+    p_ = quote + 1;
+    if ((quote - q) % 2 == 0) {
+      out = std::string_view(begin, static_cast<size_t>(quote - begin));
+      return true;
+    }
+  }
+  return fail();
+}
+
+bool JsonScanner::number(std::string_view& out) {
+  skipSpace();
+  const char* begin = p_;
+  while (p_ < end_ && ((*p_ >= '0' && *p_ <= '9') || *p_ == '-' ||
+                       *p_ == '+' || *p_ == '.' || *p_ == 'e' || *p_ == 'E')) {
+    ++p_;
+  }
+  if (p_ == begin) return fail();
+  out = std::string_view(begin, static_cast<size_t>(p_ - begin));
+  return true;
+}
+
+bool JsonScanner::scalar(std::string_view& out) {
+  if (failed_) return false;
+  return peek() == Type::kString ? string(out) : number(out);
+}
+
+bool JsonScanner::boolean(bool& out) {
+  skipSpace();
+  size_t left = static_cast<size_t>(end_ - p_);
+  if (left >= 4 && memcmp(p_, "true", 4) == 0) {
+    p_ += 4;
+    out = true;
+    return true;
+  }
+  if (left >= 5 && memcmp(p_, "false", 5) == 0) {
+    p_ += 5;
+    out = false;
+    return true;
+  }
+  return fail();
+}
+
+bool JsonScanner::integer(int64_t& out) {
+  std::string_view text;
+  if (!scalar(text)) return false;
+  const char* end = text.data() + text.size();
+  auto result = std::from_chars(text.data(), end, out);
+  if (result.ec != std::errc() || result.ptr != end) out = 0;
+  return true;
+}
+
+bool JsonScanner::skip() {
+  if (failed_) return false;
+  switch (peek()) {
+    case Type::kObject:
+      return object([this](std::string_view) { return skip(); });
+    case Type::kArray:
+      return array([this] { return skip(); });
+    case Type::kString: {
+      std::string_view ignored;
+      return string(ignored);
+    }
+    case Type::kBool: {
+      bool ignored;
+      return boolean(ignored);
+    }
+    case Type::kNull:
+      if (end_ - p_ >= 4 && memcmp(p_, "null", 4) == 0) {
+        p_ += 4;
+        return true;
+      }
+      return fail();
+    case Type::kNumber: {
+      std::string_view ignored;
+      return number(ignored);
+    }
+    default:
+      return fail();
+  }
+}
+
+bool JsonScanner::finished() {
+  skipSpace();
+  return !failed_ && p_ == end_;
+}
+
+}  // namespace standx
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace standx {
+
+// Pull scanner over a JSON text, for decoding responses of a known shape
+// straight into structs without building a DOM. Strings come back as views
+// into the text, so nothing is allocated; escape sequences are left as they
+// are (the fields read this way never contain any). Once the text turns out
+// to be malformed every call returns false.
+class JsonScanner {
+public:
+    enum class Type { kEnd, kObject, kArray, kString, kNumber, kBool, kNull };
+
+    explicit JsonScanner(std::string_view text)
+        : p_(text.data()), end_(text.data() + text.size()) {}
+
+    // Type of the next value, without consuming it.
+    Type peek();
+
+    // Calls field(key) for every member; field must consume the value with
+    // one of the reads below and return its result.
+    template <typename F>
+    bool object(F&& field);
+
+    // Calls item() for every element, which must consume it.
+    template <typename F>
+    bool array(F&& item);
+
+    bool string(std::string_view& out);
+    bool boolean(bool& out);
+    // A JSON integer, or a string holding one; any other number or string
+    // reads as 0.
+    bool integer(int64_t& out);
+    // The text of a number, or the contents of a string.
+    bool scalar(std::string_view& out);
+    bool skip();
+
+    // True when nothing but whitespace is left.
+    bool finished();
+
+private:
+    void skipSpace() {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' ||
+                             *p_ == '\t')) {
+            ++p_;
+        }
+    }
+
+    bool consume(char c) {
+        skipSpace();
+        if (p_ == end_ || *p_ != c) return false;
+        ++p_;
+        return true;
+    }
+
+    bool fail() {
+        p_ = end_;
+        failed_ = true;
+        return false;
+    }
+
+    bool number(std::string_view& out);
+
+    const char* p_;
+    const char* end_;
+    bool failed_{false};
+};
+
+template <typename F>
+bool JsonScanner::object(F&& field) {
+    if (failed_ || !consume('{')) return fail();
+    if (consume('}')) return true;
+    do {
+        std::string_view key;
+        if (!string(key) || !consume(':') || !field(key)) return fail();
+    } while (consume(','));
+    return consume('}') || fail();
+}
+
+template <typename F>
+bool JsonScanner::array(F&& item) {
+    if (failed_ || !consume('[')) return fail();
+    if (consume(']')) return true;
+    do {
+        if (!item()) return fail();
+    } while (consume(','));
+    return consume(']') || fail();
+}
+
+// One member of a decoding schema: the key it matches and how its value
+// is read into T.
+template <typename T>
+struct JsonField {
+    std::string_view key;
+    bool (*read)(JsonScanner& scanner, T& out);
+};
+
+// Reads an object into out through schema; unknown members are skipped.
+template <typename T, size_t N>
+bool decodeObject(JsonScanner& scanner, T& out,
+                  const JsonField<T> (&schema)[N]) {
+    return scanner.object([&](std::string_view key) {
+        for (const auto& field : schema) {
+            if (field.key == key) return field.read(scanner, out);
+        }
+        return scanner.skip();
+    });
+}
+
+}  // namespace standx
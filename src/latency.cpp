@@ -0,0 +1,157 @@
+#include "latency.h"
+
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+namespace standx {
+
+namespace {
+
+constexpr uint64_t kHalf = LatencyHistogram::kSubBuckets / 2;
+constexpr uint64_t kMaxValue =
+    (uint64_t{1} << LatencyHistogram::kMaxBits) - 1;
+
+int highestBit(uint64_t v) { return 63 - __builtin_clzll(v); }
+
+}  // namespace
+
+LatencyHistogram::LatencyHistogram() {
+  for (auto& c : counts_) c.store(0, std::memory_order_relaxed);
+}
+
+size_t LatencyHistogram::index(uint64_t ns) {
+  if (ns < static_cast<uint64_t>(kSubBuckets)) return static_cast<size_t>(ns);
+  if (ns > kMaxValue) ns = kMaxValue;
+  // Keep the top kSubBucketBits bits: the shift picks the power of two,
+  // the remaining bits the linear bucket inside it.
+  int shift = highestBit(ns) - (kSubBucketBits - 1);
+  uint64_t top = ns >> shift;  // in [kHalf, 2 * kHalf)
+  return kSubBuckets + (shift - 1) * kHalf + (top - kHalf);
+}
+
+uint64_t LatencyHistogram::upperBound(size_t index) {
+  if (index < static_cast<size_t>(kSubBuckets)) return index;
+  size_t k = index - kSubBuckets;
+  int shift = static_cast<int>(k / kHalf) + 1;
+  uint64_t top = k % kHalf + kHalf;
+  return ((top + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(int64_t ns) {
+  if (ns < 0) ns = 0;
+  counts_[index(static_cast<uint64_t>(ns))].fetch_add(
+      1, std::memory_order_relaxed);
+  total_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(static_cast<uint64_t>(ns), std::memory_order_relaxed);
+  int64_t seen = max_.load(std::memory_order_relaxed);
+  while (ns > seen &&
+         !max_.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {
+  }
+}
+
+double LatencyHistogram::mean() const {
+  uint64_t n = count();
+  return n == 0 ? 0.0
+                : static_cast<double>(sum_.load(std::memory_order_relaxed)) / n;
+}
+
+int64_t LatencyHistogram::percentile(double p) const {
+  uint64_t n = count();
+  if (n == 0) return 0;
+  uint64_t rank = static_cast<uint64_t>(p / 100.0 * n + 0.5);
+  if (rank < 1) rank = 1;
+  if (rank > n) rank = n;
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBuckets; ++i) {
+    seen += counts_[i].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      int64_t bound = static_cast<int64_t>(upperBound(i));
+      return bound < max() ? bound : max();
+    }
+  }
+  return max();
+}
+
+void LatencyHistogram::reset() {
+  for (auto& c : counts_) c.store(0, std::memory_order_relaxed);
+  total_.store(0, std::memory_order_relaxed);
+  sum_.store(0, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+LatencyRegistry& LatencyRegistry::instance() {
+  static LatencyRegistry registry;
+  return registry;
+}
+
+LatencyHistogram& LatencyRegistry::get(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& slot = histograms_[name];
+  if (!slot) slot = std::make_unique<LatencyHistogram>();
+  return *slot;
+}
+
+std::string LatencyRegistry::report() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string out;
+  char line[256];
+  snprintf(line, sizeof(line), "%-36s %9s %10s %10s %10s %10s %10s %10s\n",
+           "latency (us)", "count", "mean", "p50", "p90", "p99", "p99.9",
+           "max");
+  out += line;
+  for (const auto& entry : histograms_) {
+    const LatencyHistogram& h = *entry.second;
+    if (h.count() == 0) continue;
+    snprintf(line, sizeof(line),
+             "%-36s %9llu %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+             entry.first.c_str(), static_cast<unsigned long long>(h.count()),
+             h.mean() / 1e3, h.percentile(50) / 1e3, h.percentile(90) / 1e3,
+             h.percentile(99) / 1e3, h.percentile(99.9) / 1e3,
+             h.max() / 1e3);
+    out += line;
+  }
+  return out;
+}
+
+void LatencyRegistry::reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& entry : histograms_) entry.second->reset();
+}
+
+LatencyHistogram& endpointLatency(const std::string& method,
+                                  const std::string& url) {
+  std::string_view verb = method.empty() ? "GET" : method;
+  std::string_view path = url;
+  size_t scheme = path.find("://");
+  size_t begin = path.find('/', scheme == path.npos ? 0 : scheme + 3);
+  path = begin == path.npos ? "/"
+                            : path.substr(begin, path.find('?', begin) - begin);
+
+  // Every request comes through here, so the histograms a thread has hit
+  // are kept without building the name or taking the registry lock. There
+  // are only a handful of endpoints.
+  struct Endpoint {
+    std::string method;
+    std::string path;
+    LatencyHistogram* histogram;
+  };
+  thread_local std::vector<Endpoint> endpoints;
+  for (const auto& endpoint : endpoints) {
+    if (endpoint.path == path && endpoint.method == verb) {
+      return *endpoint.histogram;
+    }
+  }
+  std::string name = "http ";
+  name.append(verb).append(" ").append(path);
+  LatencyHistogram& histogram = LatencyRegistry::instance().get(name);
+  endpoints.push_back({std::string(verb), std::string(path), &histogram});
+  return histogram;
+}
+
+TickTrace& currentTickTrace() {
+  thread_local TickTrace trace;
+  return trace;
+}
+
+}  // namespace standx
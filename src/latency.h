@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace standx {
+
+// Monotonic clock for stage timestamps, in nanoseconds. Same clock as
+// Quote::recv_us, so a quote time converts with * 1000.
+inline int64_t monoNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Latency histogram in the HdrHistogram layout: values below kSubBuckets
+// ns are exact, above that every power of two is split into kSubBuckets / 2
+// linear buckets, so any value is kept to within 1/32 (~3%). Covers up to
+// 2^41 ns (about 36 min); larger values are clamped. Recording is a few
+// relaxed atomic adds and safe from any thread.
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 6;
+    static constexpr int kSubBuckets = 1 << kSubBucketBits;
+    static constexpr int kMaxBits = 41;
+    static constexpr size_t kBuckets =
+        kSubBuckets + (kMaxBits - kSubBucketBits) * (kSubBuckets / 2);
+
+    LatencyHistogram();
+
+    void record(int64_t ns);
+
+    uint64_t count() const { return total_.load(std::memory_order_relaxed); }
+    int64_t max() const { return max_.load(std::memory_order_relaxed); }
+    double mean() const;
+    // Highest value equivalent to the p-th percentile (0..100), in ns.
+    int64_t percentile(double p) const;
+
+    void reset();
+
+private:
+    static size_t index(uint64_t ns);
+    static uint64_t upperBound(size_t index);
+
+    std::array<std::atomic<uint64_t>, kBuckets> counts_;
+    std::atomic<uint64_t> total_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<int64_t> max_{0};
+};
+
+// Process-wide set of named histograms, e.g. "order sent_to_response" or
+// "http POST /api/new_order".
+class LatencyRegistry {
+public:
+    static LatencyRegistry& instance();
+
+    // Created on first use and never freed, so hot paths look a histogram
+    // up once and keep the reference.
+    LatencyHistogram& get(const std::string& name);
+
+    // One line per histogram: count, mean and p50/p90/p99/p99.9/max in us.
+    std::string report() const;
+    void reset();
+
+private:
+    LatencyRegistry() = default;
+    LatencyRegistry(const LatencyRegistry&) = delete;
+    LatencyRegistry& operator=(const LatencyRegistry&) = delete;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<LatencyHistogram>> histograms_;
+};
+
+// Round-trip histogram of an HTTP endpoint, "http POST /api/new_order".
+// Each thread remembers the ones it has looked up.
+LatencyHistogram& endpointLatency(const std::string& method,
+                                  const std::string& url);
+
+// When the price behind the orders this thread is sending was received
+// and when the strategy decided on them. The strategy sets it around
+// dispatch; the client reads it as it signs each order, so the exchange
+// interface stays unchanged.
+struct TickTrace {
+    int64_t tick_ns{0};
+    int64_t decision_ns{0};
+};
+
+TickTrace& currentTickTrace();
+
+class ScopedTickTrace {
+public:
+    explicit ScopedTickTrace(const TickTrace& trace)
+        : saved_(currentTickTrace()) {
+        currentTickTrace() = trace;
+    }
+    ~ScopedTickTrace() { currentTickTrace() = saved_; }
+
+    ScopedTickTrace(const ScopedTickTrace&) = delete;
+    ScopedTickTrace& operator=(const ScopedTickTrace&) = delete;
+
+private:
+    TickTrace saved_;
+};
+
+}  // namespace standx
@@ -1,15 +1,25 @@
+#include <atomic>
+#include <csignal>
 #include <fstream>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "Poco/AutoPtr.h"
 #include "Poco/Exception.h"
 #include "Poco/File.h"
 #include "Poco/Util/PropertyFileConfiguration.h"
+#include "connection_pool.h"
 #include "data.h"
+#include "journal.h"
+#include "latency.h"
+#include "market_data.h"
+#include "order_stream.h"
+#include "session.h"
 #include "standx_client.h"
-#include "strategy.h"
+#include "strategy_host.h"
 #include "tracer.h"
 #include "util.h"
 
@@ -19,6 +29,10 @@ using Poco::NotFoundException;
 using Poco::Util::AbstractConfiguration;
 using Poco::Util::PropertyFileConfiguration;
 
+std::atomic<bool> g_dump_latency{false};
+
+void OnDumpLatency(int) { g_dump_latency = true; }
+
 void InitConfig() {
   try {
     Poco::File dir("log");
@@ -37,17 +51,49 @@ void InitConfig() {
     kConfig.logName = config->getString("log.logName");
     kConfig.logSize = config->getString("log.logSize");
     kConfig.logLevel = config->getString("log.logLevel");
+    kConfig.logAsync = config->getBool("log.async", true);
+    kConfig.logAsyncRingKb = config->getInt("log.asyncRingKb", 1024);
+    kConfig.logAsyncOverflow = config->getString("log.asyncOverflow", "drop");
 
     kConfig.barkServer = config->getString("bark.server");
+    kConfig.journalEnable = config->getBool("journal.enable", true);
+    kConfig.journalPath =
+        config->getString("journal.path", "log/journal.bin");
     kConfig.subBtcSize = config->getDouble("sub.btcSize");
     kConfig.subEthSize = config->getDouble("sub.ethSize");
     kConfig.subSolSize = config->getDouble("sub.solSize");
     kConfig.gridLong = config->getBool("grid.long");
     kConfig.gridShort = config->getBool("grid.short");
+    kConfig.apiBaseUrl =
+        config->getString("api.baseUrl", "https://perps.standx.com");
+    kConfig.authBaseUrl =
+        config->getString("auth.baseUrl", "https://api.standx.com");
+    kConfig.httpPoolSize = config->getInt("http.poolSize", 4);
+    kConfig.httpIdleTimeout = config->getInt("http.idleTimeout", 60000);
+    kConfig.wsEnable = config->getBool("ws.enable", true);
+    kConfig.wsUrl =
+        config->getString("ws.url", "wss://perps.standx.com/ws-stream/v1");
+    kConfig.wsOrderStream = config->getBool("ws.orderStream", true);
+    kConfig.wsCaLocation = config->getString("ws.caLocation", "");
+    kConfig.strategyWaitStrategy =
+        config->getString("strategy.waitStrategy", "block");
+    kConfig.strategyTickIntervalMs =
+        config->getInt("strategy.tickIntervalMs", 1000);
+    kConfig.strategyCpu = config->getInt("strategy.cpu", -1);
+    kConfig.strategyWorkers = config->getInt("strategy.workers", 0);
+    kConfig.signCpu = config->getInt("sign.cpu", -1);
 
     logger::Tracer::Init("default", kConfig.logName, kConfig.logSize);
     logger::Tracer::Init("api", "log/api.log", kConfig.logSize);
     logger::Tracer::SetLevel(kConfig.logLevel);
+    if (kConfig.logAsync) {
+      logger::Tracer::StartAsync(
+          static_cast<size_t>(kConfig.logAsyncRingKb) * 1024,
+          logger::ParseOverflowPolicy(kConfig.logAsyncOverflow));
+    }
+
+    standx::ConnectionPool::instance().configure(kConfig.httpPoolSize,
+                                                 kConfig.httpIdleTimeout);
   } catch (NotFoundException& e) {
     std::cerr << "Config not found: " << e.what() << std::endl;
     exit(-1);
@@ -58,16 +104,66 @@ int main() {
   InitConfig();
   NOTICE("standx start");
 
+  if (kConfig.journalEnable) {
+    std::string error;
+    if (!standx::Journal::instance().open(kConfig.journalPath, error)) {
+      ERROR("Trade journal disabled: " << error);
+    }
+  }
+
   std::string chain = kConfig.chain;
   std::string private_key = kConfig.secretKey;
 
-  auto client = std::make_shared<standx::StandXClient>(chain, private_key,
-                                                       kConfig.whiteList);
-  auto strategy = std::make_shared<Strategy>(client);
-  strategy->start();
+  std::vector<std::string> symbols =
+      StrategyHost::ParseSymbols(kConfig.whiteList);
+  if (symbols.empty()) {
+    std::cerr << "order.whiteList has no symbols" << std::endl;
+    return -1;
+  }
+
+  // One login and one set of connections for every symbol.
+  standx::Endpoints endpoints;
+  endpoints.api = kConfig.apiBaseUrl;
+  endpoints.auth = kConfig.authBaseUrl;
+  auto session = std::make_shared<standx::Session>(chain, private_key,
+                                                  endpoints, kConfig.signCpu);
+  auto host = std::make_shared<StrategyHost>(session, symbols,
+                                             kConfig.strategyWorkers);
+
+  std::shared_ptr<standx::MarketDataFeed> feed;
+  if (kConfig.wsEnable) {
+    feed = std::make_shared<standx::MarketDataFeed>(kConfig.wsUrl, symbols);
+    host->SetMarketDataFeed(feed);
+    feed->start();
+  }
+
+  std::shared_ptr<standx::OrderEventStream> order_stream;
+  if (kConfig.wsEnable && kConfig.wsOrderStream) {
+    order_stream = std::make_shared<standx::OrderEventStream>(
+        kConfig.wsUrl, [session]() { return session->access_token(); });
+    host->SetOrderEventStream(order_stream);
+    order_stream->start();
+  }
+  host->start();
+
+  // kill -USR1 <pid> writes the latency histograms to the log.
+  std::signal(SIGUSR1, OnDumpLatency);
 
+  int tick = 0;
   while (1) {
     SLEEP_MS(1000);
+    standx::Journal::instance().flush();
+    if (g_dump_latency.exchange(false)) {
+      NOTICE("latency report\n"
+             << standx::LatencyRegistry::instance().report());
+    }
+    if (++tick % 60 == 0) {
+      auto stats = standx::ConnectionPool::instance().stats();
+      NOTICE("http pool requests: " << stats.requests
+                                    << ", reused: " << stats.reused
+                                    << ", connects: " << stats.connects
+                                    << ", reuse rate: " << stats.reuse_rate());
+    }
   }
 
   return 0;
@@ -0,0 +1,48 @@
+#include "mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace standx {
+
+MappedFile::~MappedFile() { close(); }
+
+void MappedFile::close() {
+  if (map_ != nullptr) munmap(map_, size_);
+  map_ = nullptr;
+  size_ = 0;
+}
+
+bool MappedFile::open(const std::string& path, std::string& error) {
+  close();
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    error = "cannot open " + path;
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    ::close(fd);
+    error = "cannot stat " + path;
+    return false;
+  }
+  size_t size = static_cast<size_t>(st.st_size);
+  if (size == 0) {
+    ::close(fd);
+    return true;
+  }
+  void* map = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED) {
+    error = "mmap failed: " + path;
+    return false;
+  }
+  madvise(map, size, MADV_SEQUENTIAL);
+  map_ = map;
+  size_ = size;
+  return true;
+}
+
+}  // namespace standx
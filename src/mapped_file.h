@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace standx {
+
+// The binary files (ticks, journal) are little-endian on disk whatever the
+// host order is.
+inline void putLE(uint64_t v, char* out) {
+    for (int i = 0; i < 8; ++i) out[i] = static_cast<char>(v >> (8 * i));
+}
+
+inline uint64_t getLE(const char* in) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) {
+        v |= static_cast<uint64_t>(static_cast<unsigned char>(in[i]))
+             << (8 * i);
+    }
+    return v;
+}
+
+// Read-only memory mapping of a whole file, advised for sequential reads.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path, std::string& error);
+    void close();
+
+    // Page aligned; null for an empty file.
+    const char* data() const { return static_cast<const char*>(map_); }
+    size_t size() const { return size_; }
+
+private:
+    void* map_{nullptr};
+    size_t size_{0};
+};
+
+// A mapped file of a fixed header followed by packed little-endian records
+// of T. On little-endian hosts the records are used in place, so any number
+// of readers share one copy through the page cache; T must then match the
+// on-disk layout and the header keep it aligned. Big-endian hosts decode a
+// copy.
+template <typename T>
+class MappedRecords {
+public:
+    using CheckHeader = bool (*)(const char* header);
+    using Decode = void (*)(const char* in, T& out);
+
+    // what names the format in errors, e.g. "tick file".
+    bool open(const std::string& path, size_t header_size,
+              CheckHeader check_header, Decode decode, const char* what,
+              std::string& error) {
+        data_ = nullptr;
+        size_ = 0;
+        decoded_.clear();
+        if (!file_.open(path, error)) return false;
+        if (file_.size() < header_size || !check_header(file_.data())) {
+            file_.close();
+            error = path + ": not a " + what;
+            return false;
+        }
+        const char* records = file_.data() + header_size;
+        size_ = (file_.size() - header_size) / sizeof(T);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        (void)decode;
+        data_ = reinterpret_cast<const T*>(records);
+#else
+        decoded_.resize(size_);
+        for (size_t i = 0; i < size_; ++i) {
+            decode(records + i * sizeof(T), decoded_[i]);
+        }
+        data_ = decoded_.data();
+#endif
+        return true;
+    }
+
+    const T* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    MappedFile file_;
+    const T* data_{nullptr};
+    size_t size_{0};
+    std::vector<T> decoded_;  // big-endian hosts only
+};
+
+}  // namespace standx
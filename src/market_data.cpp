@@ -0,0 +1,171 @@
+#include "market_data.h"
+
+#include <chrono>
+#include <nlohmann/json.hpp>
+
+#include "tracer.h"
+#include "util.h"
+
+namespace standx {
+
+namespace {
+
+int64_t steadyNowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+double numberField(const nlohmann::json& j) {
+  if (j.is_string()) return safeStof(j.get<std::string>());
+  if (j.is_number()) return j.get<double>();
+  return 0.0;
+}
+
+}  // namespace
+
+int64_t Quote::age_ms() const { return (steadyNowUs() - recv_us) / 1000; }
+
+void QuoteSlot::store(const Quote& q) {
+  uint64_t seq = seq_.load(std::memory_order_relaxed);
+  seq_.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  last_.store(q.last, std::memory_order_relaxed);
+  mark_.store(q.mark, std::memory_order_relaxed);
+  bid_.store(q.bid, std::memory_order_relaxed);
+  ask_.store(q.ask, std::memory_order_relaxed);
+  recv_us_.store(q.recv_us, std::memory_order_relaxed);
+  bbo_us_.store(q.bbo_us, std::memory_order_relaxed);
+  seq_.store(seq + 2, std::memory_order_release);
+}
+
+void QuoteSlot::store_last(double last, double mark, int64_t recv_us) {
+  Quote q;
+  load(q);
+  q.last = last;
+  if (mark > 0) q.mark = mark;
+  q.recv_us = recv_us;
+  store(q);
+}
+
+void QuoteSlot::store_bbo(double bid, double ask, int64_t recv_us) {
+  Quote q;
+  load(q);
+  q.bid = bid;
+  q.ask = ask;
+  q.bbo_us = recv_us;
+  store(q);
+}
+
+bool QuoteSlot::load(Quote& out) const {
+  while (true) {
+    uint64_t before = seq_.load(std::memory_order_acquire);
+    if (before & 1) continue;
+    out.last = last_.load(std::memory_order_relaxed);
+    out.mark = mark_.load(std::memory_order_relaxed);
+    out.bid = bid_.load(std::memory_order_relaxed);
+    out.ask = ask_.load(std::memory_order_relaxed);
+    out.recv_us = recv_us_.load(std::memory_order_relaxed);
+    out.bbo_us = bbo_us_.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (seq_.load(std::memory_order_relaxed) == before) return before != 0;
+  }
+}
+
+MarketDataFeed::MarketDataFeed(const std::string& url,
+                               const std::vector<std::string>& symbols)
+    : ws_("md-feed", url) {
+  for (const auto& symbol : symbols) {
+    slots_[symbol] = std::make_unique<QuoteSlot>();
+  }
+  ws_.set_open_callback([this]() { return subscriptions(); });
+  ws_.set_message_callback(
+      [this](const std::string& text) { on_message(text); });
+}
+
+MarketDataFeed::~MarketDataFeed() { stop(); }
+
+void MarketDataFeed::start() { ws_.start(); }
+
+void MarketDataFeed::stop() { ws_.stop(); }
+
+bool MarketDataFeed::latest(const std::string& symbol, Quote& out) const {
+  auto it = slots_.find(symbol);
+  if (it == slots_.end()) return false;
+  return it->second->load(out);
+}
+
+std::vector<std::string> MarketDataFeed::subscriptions() const {
+  std::vector<std::string> frames;
+  for (const auto& slot : slots_) {
+    for (const char* channel : {"price", "depth_book"}) {
+      nlohmann::json sub;
+      sub["subscribe"]["channel"] = channel;
+      sub["subscribe"]["symbol"] = slot.first;
+      frames.push_back(sub.dump());
+    }
+  }
+  return frames;
+}
+
+void MarketDataFeed::on_message(const std::string& text) {
+  int64_t now_us = steadyNowUs();
+  auto json = nlohmann::json::parse(text, nullptr, false);
+  if (json.is_discarded() || !json.contains("channel") ||
+      !json.contains("data")) {
+    DEBUG("md-feed ignore message: " << text);
+    return;
+  }
+
+  std::string symbol = json.value("symbol", "");
+  const auto& data = json["data"];
+  if (symbol.empty() && data.contains("symbol")) {
+    symbol = data.value("symbol", "");
+  }
+  auto it = slots_.find(symbol);
+  if (it == slots_.end()) return;
+
+  std::string channel = json["channel"].get<std::string>();
+  if (channel == "price") {
+    double last = data.contains("last_price") ? numberField(data["last_price"])
+                                              : 0.0;
+    double mark = data.contains("mark_price") ? numberField(data["mark_price"])
+                                              : 0.0;
+    if (last > 0) {
+      it->second->store_last(last, mark, now_us);
+      for (const auto& listener : listeners_) listener(symbol, last);
+    }
+    if (data.contains("spread") && data["spread"].is_array() &&
+        data["spread"].size() == 2) {
+      double bid = numberField(data["spread"][0]);
+      double ask = numberField(data["spread"][1]);
+      if (bid > 0 && ask > 0) it->second->store_bbo(bid, ask, now_us);
+    }
+  } else if (channel == "depth_book") {
+    if (!data.is_object() || !data.contains("bids") ||
+        !data.contains("asks")) {
+      return;
+    }
+    const auto& bids = data["bids"];
+    const auto& asks = data["asks"];
+    if (bids.is_array() && asks.is_array()) {
+      // Levels are not guaranteed to be sorted; take the true best. A level
+      // is [price, qty]; anything else is skipped.
+      double bid = 0.0;
+      double ask = 0.0;
+      for (const auto& level : bids) {
+        if (!level.is_array() || level.empty()) continue;
+        double p = numberField(level[0]);
+        if (p > bid) bid = p;
+      }
+      for (const auto& level : asks) {
+        if (!level.is_array() || level.empty()) continue;
+        double p = numberField(level[0]);
+        if (ask == 0.0 || (p > 0 && p < ask)) ask = p;
+      }
+      if (bid > 0 && ask > 0) it->second->store_bbo(bid, ask, now_us);
+    }
+  }
+}
+
+}  // namespace standx
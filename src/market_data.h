@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ws_client.h"
+
+namespace standx {
+
+struct Quote {
+    double last{0.0};
+    double mark{0.0};
+    double bid{0.0};
+    double ask{0.0};
+    int64_t recv_us{0};  // steady clock, microseconds, of the last price
+    int64_t bbo_us{0};   // steady clock, microseconds, of the bid/ask
+
+    // Age of the last price in milliseconds against the same steady clock.
+    int64_t age_ms() const;
+};
+
+// Latest quote for one symbol. Single writer (the feed thread), any number
+// of readers; a sequence lock keeps reads lock-free and consistent.
+class QuoteSlot {
+public:
+    void store(const Quote& q);
+    void store_last(double last, double mark, int64_t recv_us);
+    void store_bbo(double bid, double ask, int64_t recv_us);
+
+    // Returns false if nothing has been published yet.
+    bool load(Quote& out) const;
+
+private:
+    std::atomic<uint64_t> seq_{0};
+    std::atomic<double> last_{0.0};
+    std::atomic<double> mark_{0.0};
+    std::atomic<double> bid_{0.0};
+    std::atomic<double> ask_{0.0};
+    std::atomic<int64_t> recv_us_{0};
+    std::atomic<int64_t> bbo_us_{0};
+};
+
+// Streams price and top-of-book for a fixed symbol set over the public
+// StandX WebSocket and keeps a QuoteSlot per symbol.
+class MarketDataFeed {
+public:
+    using Listener = std::function<void(const std::string& symbol, double last)>;
+
+    MarketDataFeed(const std::string& url, const std::vector<std::string>& symbols);
+    ~MarketDataFeed();
+
+    void start();
+    void stop();
+
+    bool is_connected() const { return ws_.is_connected(); }
+
+    // Latest quote for symbol; false if the symbol is unknown or no data yet.
+    bool latest(const std::string& symbol, Quote& out) const;
+
+    // Called on the feed thread after each new last price has been stored.
+    // Register before start(); the list is not guarded.
+    void add_listener(Listener listener) { listeners_.push_back(listener); }
+
+private:
+    std::vector<std::string> subscriptions() const;
+    void on_message(const std::string& text);
+
+    // Built once in the constructor and never modified, so lookups need no lock.
+    std::map<std::string, std::unique_ptr<QuoteSlot>> slots_;
+    std::vector<Listener> listeners_;
+    WsClient ws_;
+};
+
+}  // namespace standx
@@ -0,0 +1,529 @@
+#include "mock_server.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <nlohmann/json.hpp>
+#include <random>
+#include <stdexcept>
+
+#include "Poco/Net/HTTPRequestHandler.h"
+#include "Poco/Net/HTTPRequestHandlerFactory.h"
+#include "Poco/Net/HTTPServer.h"
+#include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/HTTPServerRequest.h"
+#include "Poco/Net/HTTPServerResponse.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/ThreadPool.h"
+#include "crypto_utils.h"
+#include "standx_client.h"
+#include "util.h"
+
+using json = nlohmann::json;
+
+namespace standx {
+
+namespace {
+
+int64_t nowMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+std::mt19937_64& rng() {
+  thread_local std::mt19937_64 gen(std::random_device{}());
+  return gen;
+}
+
+bool chance(double rate) {
+  if (rate <= 0) return false;
+  return std::uniform_real_distribution<double>(0.0, 1.0)(rng()) < rate;
+}
+
+MockReply reply(int status, const std::string& message) {
+  json body;
+  body["code"] = status == 200 ? 0 : status;
+  body["message"] = message;
+  return MockReply{status, body.dump()};
+}
+
+MockReply reply(const json& body) { return MockReply{200, body.dump()}; }
+
+// Exact decimal text of a Fixed, trailing zeros dropped.
+std::string decimal(Fixed value) {
+  int64_t raw = value.raw;
+  std::string text = raw < 0 ? "-" : "";
+  uint64_t magnitude = raw < 0 ? -static_cast<uint64_t>(raw) : raw;
+  text += std::to_string(magnitude / Fixed::kScale);
+  std::string frac = std::to_string(magnitude % Fixed::kScale);
+  frac.insert(0, 8 - frac.size(), '0');
+  while (!frac.empty() && frac.back() == '0') frac.pop_back();
+  if (!frac.empty()) text += "." + frac;
+  return text;
+}
+
+std::string base64url(const std::string& in) {
+  std::string out = base64_encode(
+      reinterpret_cast<const unsigned char*>(in.data()), in.size());
+  for (auto& c : out) {
+    if (c == '+') c = '-';
+    if (c == '/') c = '_';
+  }
+  while (!out.empty() && out.back() == '=') out.pop_back();
+  return out;
+}
+
+// Ids arrive as JSON numbers from StandXClient, strings from other clients.
+int64_t idValue(const json& v) {
+  if (v.is_number_integer()) return v.get<int64_t>();
+  if (v.is_string()) {
+    return static_cast<int64_t>(safeStoll(v.get<std::string>()));
+  }
+  return 0;
+}
+
+const char* statusText(OrderStatus status) {
+  switch (status) {
+    case OrderStatus::kNew:
+    case OrderStatus::kPartiallyFilled:
+      return "open";
+    case OrderStatus::kFilled:
+      return "filled";
+    case OrderStatus::kCanceled:
+      return "canceled";
+    case OrderStatus::kFailed:
+      return "rejected";
+    default:
+      return "unknown";
+  }
+}
+
+double startPrice(const std::string& symbol) {
+  if (symbol == "BTC-USD") return 100000;
+  if (symbol == "ETH-USD") return 4000;
+  if (symbol == "SOL-USD") return 200;
+  return 100;
+}
+
+}  // namespace
+
+class MockServer::RequestHandler : public Poco::Net::HTTPRequestHandler {
+public:
+  explicit RequestHandler(MockServer* server) : server_(server) {}
+
+  void handleRequest(Poco::Net::HTTPServerRequest& request,
+                     Poco::Net::HTTPServerResponse& response) override {
+    MockRequest mock;
+    mock.method = request.getMethod();
+    mock.uri = request.getURI();
+    mock.authorization = request.get("Authorization", "");
+    mock.body.assign(std::istreambuf_iterator<char>(request.stream()),
+                     std::istreambuf_iterator<char>());
+
+    MockReply out = server_->handle(mock);
+    response.setStatusAndReason(
+        static_cast<Poco::Net::HTTPResponse::HTTPStatus>(out.status));
+    response.setContentType("application/json");
+    response.setContentLength(static_cast<long>(out.body.size()));
+    response.send() << out.body;
+  }
+
+private:
+  MockServer* server_;
+};
+
+class MockServer::HandlerFactory
+    : public Poco::Net::HTTPRequestHandlerFactory {
+public:
+  explicit HandlerFactory(MockServer* server) : server_(server) {}
+
+  Poco::Net::HTTPRequestHandler* createRequestHandler(
+      const Poco::Net::HTTPServerRequest&) override {
+    return new RequestHandler(server_);
+  }
+
+private:
+  MockServer* server_;
+};
+
+MockServer::MockServer(const MockServerConfig& config) : config_(config) {
+  if (config_.symbols.empty()) {
+    throw std::invalid_argument("mock server needs at least one symbol");
+  }
+  int64_t now = nowMs();
+  for (const auto& symbol : config_.symbols) {
+    Venue v;
+    SimConfig sim = config_.sim;
+    sim.symbol = symbol;
+    v.symbol = symbol;
+    v.sim = std::make_unique<SimExchange>(sim);
+    v.price = startPrice(symbol);
+    v.sim->onTick(now, v.price);
+    venues_.push_back(std::move(v));
+  }
+}
+
+MockServer::~MockServer() { stop(); }
+
+void MockServer::start() {
+  if (running_.exchange(true)) return;
+  walker_ = std::thread(&MockServer::walk, this);
+
+  int threads = std::max(config_.threads, 2);
+  pool_ = std::make_unique<Poco::ThreadPool>(2, threads);
+  auto* params = new Poco::Net::HTTPServerParams;
+  params->setMaxThreads(threads);
+  params->setMaxQueued(1024);
+  params->setKeepAlive(true);
+  params->setMaxKeepAliveRequests(0);  // unlimited, like the real gateway
+  server_ = std::make_unique<Poco::Net::HTTPServer>(
+      new HandlerFactory(this), *pool_,
+      Poco::Net::ServerSocket(static_cast<unsigned short>(config_.port)),
+      params);
+  server_->start();
+}
+
+void MockServer::stop() {
+  if (!running_.exchange(false)) return;
+  if (server_) {
+    server_->stopAll(true);
+    server_.reset();
+  }
+  if (pool_) {
+    pool_->joinAll();
+    pool_.reset();
+  }
+  if (walker_.joinable()) walker_.join();
+}
+
+std::map<std::string, uint64_t> MockServer::requestCounts() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return counts_;
+}
+
+void MockServer::walk() {
+  double sigma = config_.volatility_bps / 10000.0;
+  std::normal_distribution<double> step(0.0, sigma);
+  while (running_) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(config_.tick_ms));
+    int64_t now = nowMs();
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& v : venues_) {
+      v.price *= std::exp(step(rng()));
+      v.sim->onTick(now, v.price);
+    }
+  }
+}
+
+MockReply MockServer::handle(const MockRequest& request) {
+  size_t mark = request.uri.find('?');
+  std::string path = request.uri.substr(0, mark);
+  Query query;
+  if (mark != std::string::npos) {
+    size_t begin = mark + 1;
+    while (begin < request.uri.size()) {
+      size_t end = request.uri.find('&', begin);
+      if (end == std::string::npos) end = request.uri.size();
+      std::string pair = request.uri.substr(begin, end - begin);
+      size_t eq = pair.find('=');
+      if (eq != std::string::npos) {
+        query[pair.substr(0, eq)] = pair.substr(eq + 1);
+      }
+      begin = end + 1;
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++counts_[path];
+  }
+
+  int delay = config_.latency_ms;
+  if (config_.jitter_ms > 0) {
+    delay += std::uniform_int_distribution<int>(0, config_.jitter_ms)(rng());
+  }
+  if (delay > 0) std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+
+  if (chance(config_.error_rate)) {
+    ++injected_;
+    return reply(503, "injected error");
+  }
+  try {
+    return route(request.method, path, query, request);
+  } catch (const std::exception& e) {
+    return reply(400, std::string("bad request: ") + e.what());
+  }
+}
+
+MockReply MockServer::route(const std::string& method,
+                            const std::string& path, const Query& query,
+                            const MockRequest& request) {
+  bool post = method == "POST";
+  if (post && path == "/v1/offchain/prepare-signin") {
+    return prepareSignin(request.body);
+  }
+  if (post && path == "/v1/offchain/login") return login(request.body);
+  if (path == "/api/query_symbol_price") return symbolPrice(query);
+  if (path.compare(0, 5, "/api/") != 0) return reply(404, "not found");
+
+  if (!authorized(request.authorization)) return reply(401, "unauthorized");
+
+  if (post) {
+    bool trading = path == "/api/new_order" || path == "/api/cancel_order" ||
+                   path == "/api/cancel_orders";
+    if (trading && chance(config_.reject_rate)) {
+      ++injected_;
+      return reply(400, "injected reject");
+    }
+    if (path == "/api/new_order") return newOrder(request.body);
+    if (path == "/api/cancel_order") return cancelOrder(request.body);
+    if (path == "/api/cancel_orders") return cancelOrders(request.body);
+  } else {
+    if (path == "/api/query_balance") return balance();
+    if (path == "/api/query_positions") return positions(query);
+    if (path == "/api/query_order") return queryOrder(query);
+    if (path == "/api/query_open_orders") return openOrders(query);
+  }
+  return reply(404, "not found");
+}
+
+bool MockServer::authorized(const std::string& authorization) {
+  static const std::string kBearer = "Bearer ";
+  if (authorization.compare(0, kBearer.size(), kBearer) != 0) return false;
+  std::string token = authorization.substr(kBearer.size());
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = tokens_.find(token);
+  if (it == tokens_.end()) return false;
+  if (it->second != 0 && nowMs() >= it->second) {
+    tokens_.erase(it);
+    return false;
+  }
+  return true;
+}
+
+MockReply MockServer::prepareSignin(const std::string& body) {
+  json req = json::parse(body);
+  std::string address = req.value("address", "");
+  std::string request_id = req.value("requestId", "");
+  if (address.empty() || request_id.empty()) {
+    return reply(400, "address and requestId are required");
+  }
+
+  uint64_t nonce;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    nonce = next_nonce_++;
+  }
+  json payload;
+  payload["address"] = address;
+  payload["requestId"] = request_id;
+  payload["message"] =
+      "localhost wants you to sign in with your Ethereum account:\n" +
+      address + "\n\nStandX mock login\n\nNonce: " + std::to_string(nonce);
+
+  json resp;
+  resp["success"] = true;
+  resp["signedData"] = base64url("{\"alg\":\"none\",\"typ\":\"JWT\"}") + "." +
+                       base64url(payload.dump()) + ".mock";
+  return reply(resp);
+}
+
+MockReply MockServer::login(const std::string& body) {
+  json req = json::parse(body);
+  if (req.value("signature", "").empty() ||
+      req.value("signedData", "").empty()) {
+    return reply(400, "signature and signedData are required");
+  }
+
+  char token[32];
+  snprintf(token, sizeof(token), "mock-%016llx",
+           static_cast<unsigned long long>(rng()()));
+  int64_t expiry =
+      config_.token_ttl_s > 0 ? nowMs() + config_.token_ttl_s * 1000LL : 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tokens_[token] = expiry;
+  }
+
+  json resp;
+  resp["token"] = token;
+  return reply(resp);
+}
+
+MockReply MockServer::balance() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // One account margins every symbol.
+  double total = config_.sim.initial_balance;
+  for (const auto& v : venues_) {
+    total += v.sim->equity() - config_.sim.initial_balance;
+  }
+  json resp;
+  resp["cross_balance"] = decimal(total);
+  resp["cross_available"] = decimal(total);
+  return reply(resp);
+}
+
+MockReply MockServer::positions(const Query& query) {
+  auto symbol = query.find("symbol");
+  json resp = json::array();
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& v : venues_) {
+    if (symbol != query.end() && symbol->second != v.symbol) continue;
+    json item;
+    item["symbol"] = v.symbol;
+    item["qty"] = decimal(v.sim->stats().position);
+    resp.push_back(item);
+  }
+  return reply(resp);
+}
+
+MockReply MockServer::symbolPrice(const Query& query) {
+  auto symbol = query.find("symbol");
+  if (symbol == query.end()) return reply(400, "symbol is required");
+  std::lock_guard<std::mutex> lock(mutex_);
+  Venue* v = venue(symbol->second);
+  if (v == nullptr) return reply(404, "unknown symbol");
+  json resp;
+  resp["symbol"] = v->symbol;
+  resp["last_price"] = decimal(v->price);
+  resp["mark_price"] = decimal(v->price);
+  return reply(resp);
+}
+
+MockReply MockServer::queryOrder(const Query& query) {
+  auto order_id = query.find("order_id");
+  auto cl_ord_id = query.find("cl_ord_id");
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t n = venues_.size();
+  for (size_t i = 0; i < n; ++i) {
+    Order order;
+    bool found = false;
+    if (order_id != query.end()) {
+      int64_t id = safeStoll(order_id->second);
+      if (id <= 0 || static_cast<size_t>(id % n) != i) continue;
+      order.id = id / n;
+      found = venues_[i].sim->detail(order);
+    } else if (cl_ord_id != query.end()) {
+      if (!parseClientOrderId(cl_ord_id->second, order.clientId)) break;
+      found = venues_[i].sim->detailByClientId(order);
+    }
+    if (!found) continue;
+    json resp;
+    resp["id"] = globalId(i, order.id);
+    resp["symbol"] = venues_[i].symbol;
+    resp["status"] = statusText(order.status);
+    return reply(resp);
+  }
+  return reply(404, "order not found");
+}
+
+MockReply MockServer::openOrders(const Query& query) {
+  auto symbol = query.find("symbol");
+  json result = json::array();
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<Order> orders;
+  for (size_t i = 0; i < venues_.size(); ++i) {
+    const Venue& v = venues_[i];
+    if (symbol != query.end() && symbol->second != v.symbol) continue;
+    v.sim->unfilledOrders(orders);
+    for (const auto& order : orders) {
+      json item;
+      item["id"] = globalId(i, order.id);
+      item["cl_ord_id"] = formatClientOrderId(order.clientId);
+      item["symbol"] = v.symbol;
+      item["side"] = order.side == OrderSide::kBuy ? "buy" : "sell";
+      item["order_type"] = "limit";
+      item["time_in_force"] = "alo";
+      item["qty"] = decimal(order.size);
+      item["price"] = decimal(order.price);
+      item["reduce_only"] = order.is_reduce_only;
+      item["status"] = statusText(order.status);
+      result.push_back(item);
+    }
+  }
+  json resp;
+  resp["result"] = result;
+  return reply(resp);
+}
+
+MockReply MockServer::newOrder(const std::string& body) {
+  json req = json::parse(body);
+  Order order;
+  order.side = parseOrderSide(req.value("side", ""));
+  if (order.side == OrderSide::kNone) return reply(400, "bad side");
+  order.type = req.value("order_type", "") == "market" ? OrderType::kMarket
+                                                       : OrderType::kLimit;
+  order.size = Fixed(std::stod(req.value("qty", "0")));
+  if (order.size.raw <= 0) return reply(400, "bad qty");
+  if (order.type == OrderType::kLimit) {
+    order.price = Fixed(std::stod(req.value("price", "0")));
+    if (order.price.raw <= 0) return reply(400, "bad price");
+  }
+  order.is_reduce_only = req.value("reduce_only", false);
+
+  // StandXClient always names its orders; make one up for other clients.
+  ClientOrderId cl_ord_id;
+  std::string cl_text = req.value("cl_ord_id", "");
+  if (cl_text.empty()) {
+    uint64_t hi = rng()();
+    uint64_t lo = rng()();
+    std::memcpy(cl_ord_id.bytes, &hi, sizeof(hi));
+    std::memcpy(cl_ord_id.bytes + sizeof(hi), &lo, sizeof(lo));
+  } else if (!parseClientOrderId(cl_text, cl_ord_id)) {
+    return reply(400, "bad cl_ord_id");
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  Venue* v = venue(req.value("symbol", ""));
+  if (v == nullptr) return reply(400, "unknown symbol");
+  if (!v->sim->placeOrder(order, cl_ord_id)) {
+    return reply(400, "duplicate cl_ord_id");
+  }
+  json resp;
+  resp["code"] = 0;
+  resp["message"] = "success";
+  resp["request_id"] = formatClientOrderId(cl_ord_id);
+  return reply(resp);
+}
+
+MockReply MockServer::cancelOrder(const std::string& body) {
+  json req = json::parse(body);
+  int64_t id = req.contains("order_id") ? idValue(req["order_id"]) : 0;
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!cancel(id)) return reply(400, "order not open");
+  return reply(200, "success");
+}
+
+MockReply MockServer::cancelOrders(const std::string& body) {
+  json req = json::parse(body);
+  if (!req.contains("order_id_list") || !req["order_id_list"].is_array()) {
+    return reply(400, "order_id_list is required");
+  }
+  // Like the venue, ids that are no longer open are skipped, not errors.
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& id : req["order_id_list"]) cancel(idValue(id));
+  return reply(200, "success");
+}
+
+int64_t MockServer::globalId(size_t venue, int64_t local) const {
+  return local * static_cast<int64_t>(venues_.size()) +
+         static_cast<int64_t>(venue);
+}
+
+MockServer::Venue* MockServer::venue(const std::string& symbol) {
+  for (auto& v : venues_) {
+    if (v.symbol == symbol) return &v;
+  }
+  return nullptr;
+}
+
+bool MockServer::cancel(int64_t id) {
+  if (id <= 0) return false;
+  int64_t n = static_cast<int64_t>(venues_.size());
+  return venues_[id % n].sim->cancelOrders({id / n})[0];
+}
+
+}  // namespace standx
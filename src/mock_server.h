@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "sim_exchange.h"
+
+namespace Poco {
+class ThreadPool;
+namespace Net {
+class HTTPServer;
+}
+}  // namespace Poco
+
+namespace standx {
+
+struct MockServerConfig {
+    int port{8080};
+    int threads{16};  // request handler threads
+    std::vector<std::string> symbols{"BTC-USD", "ETH-USD", "SOL-USD"};
+    int latency_ms{0};         // added before every response
+    int jitter_ms{0};          // plus a uniform 0..jitter_ms
+    double error_rate{0.0};    // share of requests answered 503
+    double reject_rate{0.0};   // share of new_order / cancel refused with 400
+    int token_ttl_s{0};        // tokens expire into 401s; 0 never
+    int tick_ms{100};          // price walk step
+    double volatility_bps{2.0};  // standard deviation of one step
+    SimConfig sim;             // balance and fees; the symbol is ignored
+};
+
+struct MockRequest {
+    std::string method;
+    std::string uri;            // path and query
+    std::string authorization;  // Authorization header
+    std::string body;
+};
+
+struct MockReply {
+    int status{200};
+    std::string body;
+};
+
+// Local stand-in for the StandX REST API, for measuring client overhead
+// and load testing without a live venue. It serves the auth endpoints the
+// login uses and the perps endpoints StandXClient calls, answered from one
+// SimExchange per symbol whose price follows a random walk, and can add
+// latency, 5xx errors, order rejects and token expiry.
+//
+// Signatures are accepted unchecked and there is no WebSocket stream; run
+// the client against it with ws.enable = false.
+class MockServer {
+public:
+    explicit MockServer(const MockServerConfig& config);
+    ~MockServer();
+
+    MockServer(const MockServer&) = delete;
+    MockServer& operator=(const MockServer&) = delete;
+
+    // Listen on config.port and start the price walk.
+    void start();
+    void stop();
+
+    // Serve one request, injected latency and failures included. The HTTP
+    // handlers call this; it is thread-safe and needs no socket.
+    MockReply handle(const MockRequest& request);
+
+    // Requests per endpoint path since start.
+    std::map<std::string, uint64_t> requestCounts() const;
+    uint64_t injectedFailures() const { return injected_; }
+
+private:
+    struct Venue {
+        std::string symbol;
+        std::unique_ptr<SimExchange> sim;
+        double price{0.0};
+    };
+    using Query = std::map<std::string, std::string>;
+
+    class RequestHandler;
+    class HandlerFactory;
+
+    MockReply route(const std::string& method, const std::string& path,
+                    const Query& query, const MockRequest& request);
+    bool authorized(const std::string& authorization);
+
+    MockReply prepareSignin(const std::string& body);
+    MockReply login(const std::string& body);
+    MockReply balance();
+    MockReply positions(const Query& query);
+    MockReply symbolPrice(const Query& query);
+    MockReply queryOrder(const Query& query);
+    MockReply openOrders(const Query& query);
+    MockReply newOrder(const std::string& body);
+    MockReply cancelOrder(const std::string& body);
+    MockReply cancelOrders(const std::string& body);
+
+    // Venue order ids are per symbol; the API sees local * venues + index.
+    int64_t globalId(size_t venue, int64_t local) const;
+    Venue* venue(const std::string& symbol);
+    bool cancel(int64_t id);
+
+    void walk();
+
+    MockServerConfig config_;
+    std::vector<Venue> venues_;
+    // Guards the venues, tokens and counters.
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, int64_t> tokens_;  // token -> expiry ms
+    std::map<std::string, uint64_t> counts_;
+    std::atomic<uint64_t> injected_{0};
+    uint64_t next_nonce_{1};
+
+    std::atomic<bool> running_{false};
+    std::thread walker_;
+    std::unique_ptr<Poco::ThreadPool> pool_;
+    std::unique_ptr<Poco::Net::HTTPServer> server_;
+};
+
+}  // namespace standx
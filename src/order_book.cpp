@@ -0,0 +1,111 @@
+#include "order_book.h"
+
+#include <cmath>
+#include <cstdlib>
+
+namespace standx {
+
+int64_t OrderBook::tick_of(const Order& order) const {
+  return std::llround(static_cast<double>(order.price) / tick_size_);
+}
+
+uint64_t OrderBook::level_key(PositionSide position_side, bool reduce_only,
+                              int64_t tick) {
+  return (static_cast<uint64_t>(tick) << 3) |
+         (static_cast<uint64_t>(position_side) << 1) |
+         (reduce_only ? 1u : 0u);
+}
+
+void OrderBook::index(uint32_t i) {
+  Slot& slot = slots_[i];
+  const Order& order = slot.order;
+  slot.tick = tick_of(order);
+  ++level_count_[level_key(order.positionSide, order.is_reduce_only,
+                           slot.tick)];
+  if (!order.clientId.empty()) client_index_[order.clientId] = i;
+  if (order.is_reduce_only) {
+    reduce_only_raw_[static_cast<int>(order.positionSide)] +=
+        std::llabs(order.size.raw);
+  }
+}
+
+void OrderBook::unindex(uint32_t i) {
+  Slot& slot = slots_[i];
+  const Order& order = slot.order;
+  auto level = level_count_.find(
+      level_key(order.positionSide, order.is_reduce_only, slot.tick));
+  if (level != level_count_.end() && --level->second == 0) {
+    level_count_.erase(level);
+  }
+  if (!order.clientId.empty()) client_index_.erase(order.clientId);
+  if (order.is_reduce_only) {
+    reduce_only_raw_[static_cast<int>(order.positionSide)] -=
+        std::llabs(order.size.raw);
+  }
+}
+
+void OrderBook::release(uint32_t i) {
+  unindex(i);
+  id_index_.erase(slots_[i].order.id);
+  slots_[i].used = false;
+  free_.push_back(i);
+}
+
+void OrderBook::upsert(const Order& order) {
+  if (order.id == 0) return;
+  auto it = id_index_.find(order.id);
+  uint32_t i;
+  if (it != id_index_.end()) {
+    i = it->second;
+    unindex(i);
+  } else {
+    if (free_.empty()) {
+      i = static_cast<uint32_t>(slots_.size());
+      slots_.emplace_back();
+    } else {
+      i = free_.back();
+      free_.pop_back();
+    }
+    id_index_[order.id] = i;
+    slots_[i].used = true;
+  }
+  slots_[i].order = order;
+  slots_[i].generation = generation_;
+  index(i);
+}
+
+void OrderBook::erase(int64_t id) {
+  auto it = id_index_.find(id);
+  if (it != id_index_.end()) release(it->second);
+}
+
+void OrderBook::sync(const std::vector<Order>& snapshot) {
+  ++generation_;
+  for (const auto& order : snapshot) {
+    upsert(order);
+  }
+  for (uint32_t i = 0; i < slots_.size(); ++i) {
+    if (slots_[i].used && slots_[i].generation != generation_) release(i);
+  }
+}
+
+const Order* OrderBook::find(int64_t id) const {
+  auto it = id_index_.find(id);
+  return it == id_index_.end() ? nullptr : &slots_[it->second].order;
+}
+
+const Order* OrderBook::find_by_client_id(const ClientOrderId& id) const {
+  auto it = client_index_.find(id);
+  return it == client_index_.end() ? nullptr : &slots_[it->second].order;
+}
+
+bool OrderBook::contains(PositionSide position_side, bool reduce_only,
+                         int64_t tick) const {
+  return level_count_.count(level_key(position_side, reduce_only, tick)) != 0;
+}
+
+double OrderBook::reduce_only_size(PositionSide position_side) const {
+  return Fixed::fromRaw(reduce_only_raw_[static_cast<int>(position_side)]);
+}
+
+}  // namespace standx
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "data.h"
+
+namespace standx {
+
+// Local store of this symbol's open orders, indexed by exchange id, client
+// id and grid level (position side, reduce-only, price tick). Orders live in
+// reusable slots, so a refresh only touches what changed.
+class OrderBook {
+public:
+    // Price step used to derive an order's tick; set before the first sync.
+    void set_tick_size(double tick_size) { tick_size_ = tick_size; }
+    int64_t tick_of(const Order& order) const;
+
+    // Reconcile with a full open-orders snapshot: new ids are inserted,
+    // known ids updated in place and ids missing from it removed.
+    void sync(const std::vector<Order>& snapshot);
+
+    void upsert(const Order& order);
+    void erase(int64_t id);
+
+    const Order* find(int64_t id) const;
+    const Order* find_by_client_id(const ClientOrderId& id) const;
+
+    // Whether any open order sits at this level.
+    bool contains(PositionSide position_side, bool reduce_only,
+                  int64_t tick) const;
+
+    // Total open reduce-only size for a position side.
+    double reduce_only_size(PositionSide position_side) const;
+
+    size_t size() const { return id_index_.size(); }
+
+    template <typename F>
+    void for_each(F f) const {
+        for (const auto& slot : slots_) {
+            if (slot.used) f(slot.order);
+        }
+    }
+
+    // Remove every order for which pred returns true.
+    template <typename F>
+    void erase_if(F pred) {
+        for (uint32_t i = 0; i < slots_.size(); ++i) {
+            if (slots_[i].used && pred(slots_[i].order)) release(i);
+        }
+    }
+
+private:
+    struct Slot {
+        Order order;
+        int64_t tick{0};
+        uint64_t generation{0};
+        bool used{false};
+    };
+
+    static uint64_t level_key(PositionSide position_side, bool reduce_only,
+                              int64_t tick);
+    void index(uint32_t i);
+    void unindex(uint32_t i);
+    void release(uint32_t i);
+
+    double tick_size_{1.0};
+    uint64_t generation_{0};
+    std::vector<Slot> slots_;
+    std::vector<uint32_t> free_;
+    std::unordered_map<int64_t, uint32_t> id_index_;
+    std::unordered_map<ClientOrderId, uint32_t, ClientOrderIdHash>
+        client_index_;
+    std::unordered_map<uint64_t, uint32_t> level_count_;
+    int64_t reduce_only_raw_[3]{0, 0, 0};  // by PositionSide
+};
+
+}  // namespace standx
@@ -0,0 +1,171 @@
+#include "order_stream.h"
+
+#include <chrono>
+#include <nlohmann/json.hpp>
+
+#include "standx_client.h"
+#include "tracer.h"
+#include "util.h"
+
+namespace standx {
+
+namespace {
+
+const int64_t kTerminalRetainUs = 10LL * 60 * 1000 * 1000;
+const uint64_t kPruneEvery = 1024;
+
+int64_t steadyNowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+float floatField(const nlohmann::json& j, const char* key) {
+  if (!j.contains(key)) return 0.0f;
+  const auto& v = j[key];
+  if (v.is_string()) return safeStof(v.get<std::string>());
+  if (v.is_number()) return v.get<float>();
+  return 0.0f;
+}
+
+bool isTerminal(OrderStatus status) {
+  return status == OrderStatus::kFilled || status == OrderStatus::kCanceled ||
+         status == OrderStatus::kFailed;
+}
+
+}  // namespace
+
+void OrderStateTable::apply(const OrderState& state) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  upsert_locked(state);
+}
+
+void OrderStateTable::seed(const OrderState& state) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (orders_.count(state.id)) return;
+  upsert_locked(state);
+}
+
+void OrderStateTable::upsert_locked(const OrderState& state) {
+  if (state.id == 0) return;
+  OrderState& entry = orders_[state.id];
+  entry = state;
+  entry.update_us = steadyNowUs();
+  if (!state.cl_ord_id.empty()) client_ids_[state.cl_ord_id] = state.id;
+
+  if (++updates_ % kPruneEvery == 0) prune_locked(entry.update_us);
+}
+
+void OrderStateTable::prune_locked(int64_t now_us) {
+  for (auto it = orders_.begin(); it != orders_.end();) {
+    if (isTerminal(it->second.status) &&
+        now_us - it->second.update_us > kTerminalRetainUs) {
+      if (!it->second.cl_ord_id.empty()) client_ids_.erase(it->second.cl_ord_id);
+      it = orders_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+bool OrderStateTable::find(int64_t id, OrderState& out) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = orders_.find(id);
+  if (it == orders_.end()) return false;
+  out = it->second;
+  return true;
+}
+
+bool OrderStateTable::find_by_client_id(const ClientOrderId& cl_ord_id,
+                                        OrderState& out) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = client_ids_.find(cl_ord_id);
+  if (it == client_ids_.end()) return false;
+  auto order = orders_.find(it->second);
+  if (order == orders_.end()) return false;
+  out = order->second;
+  return true;
+}
+
+void OrderStateTable::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  orders_.clear();
+  client_ids_.clear();
+}
+
+OrderEventStream::OrderEventStream(const std::string& url,
+                                   TokenProvider token_provider)
+    : token_provider_(token_provider), ws_("order-stream", url) {
+  ws_.set_open_callback([this]() { return on_open(); });
+  ws_.set_message_callback(
+      [this](const std::string& text) { on_message(text); });
+  ws_.set_close_callback([this]() { authenticated_ = false; });
+}
+
+OrderEventStream::~OrderEventStream() { stop(); }
+
+void OrderEventStream::start() { ws_.start(); }
+
+void OrderEventStream::stop() { ws_.stop(); }
+
+std::vector<std::string> OrderEventStream::on_open() {
+  // Transitions may have been missed while disconnected; force a re-seed.
+  // The table is not trusted again until the auth reply says so.
+  authenticated_ = false;
+  table_.clear();
+
+  nlohmann::json auth;
+  auth["auth"]["token"] = token_provider_();
+  auth["auth"]["streams"] = nlohmann::json::array({{{"channel", "order"}}});
+  return {auth.dump()};
+}
+
+void OrderEventStream::on_message(const std::string& text) {
+  auto json = nlohmann::json::parse(text, nullptr, false);
+  if (!json.is_discarded() && json.value("channel", "") == "auth") {
+    // {"channel": "auth", "data": {"code": 0, "msg": "success"}}
+    const auto& data = json.contains("data") ? json["data"] : json;
+    int code = data.is_object() && data.contains("code") &&
+                       data["code"].is_number_integer()
+                   ? data["code"].get<int>()
+                   : -1;
+    if (code == 0) {
+      authenticated_ = true;
+      NOTICE("order-stream authenticated");
+    } else {
+      authenticated_ = false;
+      ERROR("order-stream auth failed, polling orders over REST: " << text);
+    }
+    return;
+  }
+  if (json.is_discarded() || json.value("channel", "") != "order" ||
+      !json.contains("data")) {
+    DEBUG("order-stream ignore message: " << text);
+    return;
+  }
+
+  const auto& data = json["data"];
+  OrderState state;
+  if (data.contains("id") && data["id"].is_number_integer()) {
+    state.id = data["id"].get<int64_t>();
+  } else if (data.contains("id") && data["id"].is_string()) {
+    state.id = static_cast<int64_t>(safeStoll(data["id"].get<std::string>()));
+  }
+  if (state.id == 0) return;
+
+  parseClientOrderId(data.value("cl_ord_id", ""), state.cl_ord_id);
+  state.symbol = data.value("symbol", "");
+  state.side = parseOrderSide(data.value("side", ""));
+  state.status = mapOrderStatus(data.value("status", ""));
+  state.price = floatField(data, "price");
+  state.qty = floatField(data, "qty");
+  state.fill_qty = floatField(data, "fill_qty");
+  state.reduce_only = data.value("reduce_only", false);
+
+  table_.apply(state);
+  DEBUG("order-stream " << state.id << " " << state.side << " "
+                        << state.price << " -> " << state.status);
+  for (const auto& listener : listeners_) listener(state);
+}
+
+}  // namespace standx
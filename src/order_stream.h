@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "data.h"
+#include "ws_client.h"
+
+namespace standx {
+
+struct OrderState {
+    int64_t id{0};
+    ClientOrderId cl_ord_id;
+    std::string symbol;
+    OrderSide side{OrderSide::kNone};
+    OrderStatus status{OrderStatus::kNone};  // see mapOrderStatus
+    float price{0.0};
+    float qty{0.0};
+    float fill_qty{0.0};
+    bool reduce_only{false};
+    int64_t update_us{0};  // steady clock, microseconds
+};
+
+// Local view of order states fed by the private order stream. Events always
+// win; REST results are only used to seed orders the stream has not reported.
+class OrderStateTable {
+public:
+    // Apply a pushed state transition.
+    void apply(const OrderState& state);
+
+    // Record a polled state unless an event already covered the order.
+    void seed(const OrderState& state);
+
+    bool find(int64_t id, OrderState& out) const;
+    bool find_by_client_id(const ClientOrderId& cl_ord_id, OrderState& out) const;
+
+    // Forget everything, e.g. after a reconnect when events may be missing.
+    void clear();
+
+private:
+    void upsert_locked(const OrderState& state);
+    void prune_locked(int64_t now_us);
+
+    mutable std::mutex mutex_;
+    std::unordered_map<int64_t, OrderState> orders_;
+    std::unordered_map<ClientOrderId, int64_t, ClientOrderIdHash> client_ids_;
+    uint64_t updates_{0};
+};
+
+// Authenticated WebSocket subscription to the account's order channel.
+class OrderEventStream {
+public:
+    using TokenProvider = std::function<std::string()>;
+    using Listener = std::function<void(const OrderState&)>;
+
+    OrderEventStream(const std::string& url, TokenProvider token_provider);
+    ~OrderEventStream();
+
+    void start();
+    void stop();
+
+    // Connected and the venue has accepted the auth frame; only then do
+    // order events arrive and the table can be trusted.
+    bool is_connected() const {
+        return ws_.is_connected() &&
+               authenticated_.load(std::memory_order_acquire);
+    }
+
+    OrderStateTable& table() { return table_; }
+
+    // Called on the stream thread after each event has been applied.
+    // Register before start(); the list is not guarded.
+    void add_listener(Listener listener) { listeners_.push_back(listener); }
+
+private:
+    std::vector<std::string> on_open();
+    void on_message(const std::string& text);
+
+    TokenProvider token_provider_;
+    std::vector<Listener> listeners_;
+    OrderStateTable table_;
+    std::atomic<bool> authenticated_{false};
+    WsClient ws_;
+};
+
+}  // namespace standx
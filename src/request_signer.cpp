@@ -0,0 +1,138 @@
+#include "request_signer.h"
+
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <thread>
+
+#include "auth.h"
+#include "crypto_utils.h"
+
+namespace standx {
+
+namespace {
+
+// The byte groups of the 8-4-4-4-12 UUID text: first byte, number of
+// bytes and where their digits start in the text.
+struct IdGroup {
+  uint8_t byte;
+  uint8_t size;
+  uint8_t text;
+};
+
+constexpr IdGroup kIdGroups[5] = {
+    {0, 4, 0}, {4, 2, 9}, {6, 2, 14}, {8, 2, 19}, {10, 6, 24}};
+
+constexpr char kSignVersion[] = "v1";
+constexpr size_t kSignatureSize = 64;  // Ed25519
+
+uint64_t splitMix64(uint64_t& x) {
+  uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+}  // namespace
+
+RequestSigner& RequestSigner::local() {
+  thread_local RequestSigner signer;
+  return signer;
+}
+
+RequestSigner::RequestSigner() {
+  std::random_device rd;
+  uint64_t seed = (static_cast<uint64_t>(rd()) << 32) ^ rd();
+  seed ^= std::hash<std::thread::id>()(std::this_thread::get_id());
+  seed ^= static_cast<uint64_t>(
+      std::chrono::steady_clock::now().time_since_epoch().count());
+  for (auto& s : state_) s = splitMix64(seed);
+  message_.reserve(512);
+}
+
+uint64_t RequestSigner::next() {
+  // xoshiro256**
+  uint64_t result = rotl(state_[1] * 5, 7) * 9;
+  uint64_t t = state_[1] << 17;
+  state_[2] ^= state_[0];
+  state_[3] ^= state_[1];
+  state_[1] ^= state_[2];
+  state_[0] ^= state_[3];
+  state_[2] ^= t;
+  state_[3] = rotl(state_[3], 45);
+  return result;
+}
+
+ClientOrderId RequestSigner::newId() {
+  uint64_t hi = next();
+  uint64_t lo = next();
+  ClientOrderId id;
+  std::memcpy(id.bytes, &hi, sizeof(hi));
+  std::memcpy(id.bytes + sizeof(hi), &lo, sizeof(lo));
+  id.bytes[6] = (id.bytes[6] & 0x0F) | 0x40;  // version 4
+  id.bytes[8] = (id.bytes[8] & 0x3F) | 0x80;  // RFC 4122 variant
+  return id;
+}
+
+void RequestSigner::formatId(const ClientOrderId& id, char* out) {
+  out[8] = out[13] = out[18] = out[23] = '-';
+  for (const auto& group : kIdGroups) {
+    hex_encode(id.bytes + group.byte, group.size, out + group.text);
+  }
+}
+
+bool RequestSigner::parseId(std::string_view text, ClientOrderId& out) {
+  out = ClientOrderId();
+  if (text.size() != kIdTextSize || text[8] != '-' || text[13] != '-' ||
+      text[18] != '-' || text[23] != '-') {
+    return false;
+  }
+  for (const auto& group : kIdGroups) {
+    if (!hex_decode(text.data() + group.text, 2 * group.size,
+                    out.bytes + group.byte)) {
+      out = ClientOrderId();
+      return false;
+    }
+  }
+  return true;
+}
+
+void RequestSigner::sign(AuthManager& auth, const std::string& body,
+                         const ClientOrderId& request_id,
+                         std::vector<std::string>& headers) {
+  char id[kIdTextSize];
+  formatId(request_id, id);
+
+  char timestamp[24];
+  int64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+                   .count();
+  size_t timestamp_size = static_cast<size_t>(
+      std::to_chars(timestamp, timestamp + sizeof(timestamp), ms).ptr -
+      timestamp);
+
+  message_.clear();
+  message_.append(kSignVersion).append(1, ',');
+  message_.append(id, sizeof(id)).append(1, ',');
+  message_.append(timestamp, timestamp_size).append(1, ',');
+  message_.append(body);
+  unsigned char signature[kSignatureSize];
+  auth.sign_ed25519(message_, signature);
+
+  headers.resize(5);
+  headers[0].assign("Content-Type: application/json");
+  headers[1].assign("x-request-sign-version: ").append(kSignVersion);
+  headers[2].assign("x-request-id: ").append(id, sizeof(id));
+  headers[3].assign("x-request-timestamp: ").append(timestamp, timestamp_size);
+  // Encoded straight into the header, with no temporary string.
+  std::string& header = headers[4];
+  header.assign("x-request-signature: ");
+  size_t prefix = header.size();
+  header.resize(prefix + base64_encoded_size(kSignatureSize));
+  base64_encode(signature, kSignatureSize, &header[prefix]);
+}
+
+}  // namespace standx
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "data.h"
+
+namespace standx {
+
+class AuthManager;
+
+// Builds the signed headers of StandX trading requests. One instance per
+// thread (see local()), so its random state and message buffer are used
+// without locking and the buffer's capacity is reused from call to call.
+class RequestSigner {
+public:
+    static constexpr size_t kIdTextSize = 36;  // 8-4-4-4-12 UUID text
+
+    static RequestSigner& local();
+
+    // Random UUID v4 from a per-thread xoshiro256** generator; seeded once
+    // per thread from std::random_device.
+    ClientOrderId newId();
+
+    // Writes the canonical lowercase UUID text of id (no terminator).
+    static void formatId(const ClientOrderId& id, char* out);
+    // Reads UUID text of either case; out is zeroed when text is not one.
+    static bool parseId(std::string_view text, ClientOrderId& out);
+
+    // Replaces headers with Content-Type and the x-request-* headers that
+    // sign "v1,<request_id>,<timestamp ms>,<body>" with auth's Ed25519 key.
+    void sign(AuthManager& auth, const std::string& body,
+              const ClientOrderId& request_id,
+              std::vector<std::string>& headers);
+
+private:
+    RequestSigner();
+
+    uint64_t next();
+
+    uint64_t state_[4];
+    std::string message_;
+};
+
+}  // namespace standx
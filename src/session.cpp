@@ -0,0 +1,40 @@
+#include "session.h"
+
+#include "async_http_client.h"
+#include "auth.h"
+#include "http_client.h"
+#include "sign_worker.h"
+
+namespace standx {
+
+Session::Session(const std::string& chain, const std::string& private_key_hex,
+                 const Endpoints& endpoints, int sign_cpu)
+    : endpoints_(endpoints) {
+  http_ = std::make_unique<HttpClient>();
+  async_http_ = std::make_unique<AsyncHttpClient>();
+  auth_ = std::make_unique<AuthManager>(chain, endpoints_.auth);
+  auth_->set_private_key(private_key_hex);
+  signer_ = std::make_unique<SignWorker>(*auth_, sign_cpu);
+  login();
+
+  http_->set_token_refresh_callback([this]() { return login(); });
+}
+
+Session::~Session() { signer_->stop(); }
+
+std::string Session::login() {
+  std::lock_guard<std::mutex> lock(login_mutex_);
+  std::string token = auth_->login();
+  std::lock_guard<std::mutex> token_lock(token_mutex_);
+  access_token_ = token;
+  return token;
+}
+
+std::string Session::access_token() const {
+  std::lock_guard<std::mutex> lock(token_mutex_);
+  return access_token_;
+}
+
+std::string Session::address() const { return auth_->get_address(); }
+
+}  // namespace standx
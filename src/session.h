@@ -0,0 +1,64 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace standx {
+
+class AsyncHttpClient;
+class AuthManager;
+class HttpClient;
+class SignWorker;
+
+// Where the REST APIs live. Point both at a standx_mock server to trade
+// against the local mock exchange.
+struct Endpoints {
+    std::string api{"https://perps.standx.com"};
+    std::string auth{"https://api.standx.com"};
+};
+
+// One logged-in StandX account: the auth keys and access token, the
+// blocking and async HTTP engines and the request signing thread. Every
+// StandXClient of the process shares it, so trading another symbol adds no
+// login, event loop or connection set.
+class Session {
+public:
+    // Logs in immediately; throws if that fails. sign_cpu >= 0 pins the
+    // signing thread to that core.
+    Session(const std::string& chain, const std::string& private_key_hex,
+            const Endpoints& endpoints = Endpoints(), int sign_cpu = -1);
+    ~Session();
+
+    Session(const Session&) = delete;
+    Session& operator=(const Session&) = delete;
+
+    // Re-run the SIWE login and swap in the new token. Concurrent callers
+    // queue up behind the first one.
+    std::string login();
+
+    std::string access_token() const;
+    std::string address() const;
+    const Endpoints& endpoints() const { return endpoints_; }
+
+    HttpClient& http() { return *http_; }
+    AsyncHttpClient& async_http() { return *async_http_; }
+    AuthManager& auth() { return *auth_; }
+    SignWorker& signer() { return *signer_; }
+
+private:
+    Endpoints endpoints_;
+    std::unique_ptr<HttpClient> http_;
+    std::unique_ptr<AuthManager> auth_;
+    std::string access_token_;
+    mutable std::mutex token_mutex_;
+    std::mutex login_mutex_;
+    // Signed jobs end in an HTTP submit and HTTP callbacks (amends) queue
+    // signing jobs, so ~Session stops the signer first, then the event
+    // loop, whose last callbacks find the signer stopped.
+    std::unique_ptr<SignWorker> signer_;
+    // Declared last so the event loop stops before anything its callbacks use.
+    std::unique_ptr<AsyncHttpClient> async_http_;
+};
+
+}  // namespace standx
@@ -0,0 +1,75 @@
+#include "sign_worker.h"
+
+#include <exception>
+
+#include "event_queue.h"
+#include "request_signer.h"
+#include "tracer.h"
+
+namespace standx {
+
+SignWorker::SignWorker(AuthManager& auth, int cpu)
+    : auth_(auth), cpu_(cpu), thread_("signer") {
+  thread_.start(*this);
+}
+
+SignWorker::~SignWorker() { stop(); }
+
+void SignWorker::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_) return;
+    running_ = false;
+  }
+  ready_.notify_one();
+  thread_.join();
+}
+
+void SignWorker::submit(const ClientOrderId& request_id, Prepare prepare,
+                        Done done) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+      jobs_.push_back(Job{request_id, std::move(prepare), std::move(done)});
+      ready_.notify_one();
+      return;
+    }
+  }
+  std::vector<std::string> no_headers;
+  done(std::string(), no_headers, "signer stopped");
+}
+
+void SignWorker::process(Job& job) {
+  std::string body;
+  std::vector<std::string> headers;
+  try {
+    body = job.prepare();
+    RequestSigner::local().sign(auth_, body, job.request_id, headers);
+  } catch (const std::exception& e) {
+    ERROR("Failed to sign request: " << e.what());
+    headers.clear();
+    job.done(body, headers, e.what());
+    return;
+  }
+  job.done(body, headers, std::string());
+}
+
+void SignWorker::run() {
+  if (cpu_ >= 0 && !pinCurrentThread(cpu_)) {
+    WARNING("Failed to pin signer thread to cpu " << cpu_);
+  }
+
+  std::deque<Job> batch;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      ready_.wait(lock, [this] { return !running_ || !jobs_.empty(); });
+      if (!running_ && jobs_.empty()) break;
+      batch.swap(jobs_);
+    }
+    for (auto& job : batch) process(job);
+    batch.clear();
+  }
+}
+
+}  // namespace standx
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include "data.h"
+
+namespace standx {
+
+class AuthManager;
+
+// Builds and signs trading requests on a thread of its own, so a strategy
+// only queues them: during a burst the worker signs request N while N-1 is
+// already on the wire. Jobs run in submission order.
+class SignWorker : public Poco::Runnable {
+public:
+    // Builds the request body; runs on the worker.
+    using Prepare = std::function<std::string()>;
+    // Runs on the worker with the body and its signed headers, or with
+    // error set (and no headers) when preparing or signing threw.
+    using Done = std::function<void(const std::string& body,
+                                    std::vector<std::string>& headers,
+                                    const std::string& error)>;
+
+    // cpu >= 0 pins the worker thread to that core.
+    explicit SignWorker(AuthManager& auth, int cpu = -1);
+    ~SignWorker();
+
+    SignWorker(const SignWorker&) = delete;
+    SignWorker& operator=(const SignWorker&) = delete;
+
+    // After stop(), done runs at once with an error.
+    void submit(const ClientOrderId& request_id, Prepare prepare, Done done);
+
+    // Finishes the queued jobs and ends the thread.
+    void stop();
+
+    void run() override;
+
+private:
+    struct Job {
+        ClientOrderId request_id;
+        Prepare prepare;
+        Done done;
+    };
+
+    void process(Job& job);
+
+    AuthManager& auth_;
+    int cpu_;
+    bool running_{true};
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<Job> jobs_;
+    Poco::Thread thread_;
+};
+
+}  // namespace standx
@@ -0,0 +1,301 @@
+#include "sim_exchange.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace standx {
+
+namespace {
+
+template <typename T>
+std::future<T> ready(T value) {
+  std::promise<T> promise;
+  promise.set_value(value);
+  return promise.get_future();
+}
+
+bool resting(const Order& order) {
+  return order.status == OrderStatus::kNew ||
+         order.status == OrderStatus::kPartiallyFilled;
+}
+
+}  // namespace
+
+SimExchange::SimExchange(const SimConfig& config)
+    : config_(config), peak_equity_(config.initial_balance) {}
+
+double SimExchange::equity() const {
+  return config_.initial_balance + stats_.realized_pnl - stats_.fees +
+         stats_.unrealized_pnl;
+}
+
+void SimExchange::onTick(int64_t ts_ms, double price) {
+  now_ms_ = ts_ms;
+  last_ = price;
+  matchBook(bids_, true);
+  matchBook(asks_, false);
+
+  stats_.unrealized_pnl = stats_.position * (last_ - avg_price_);
+  double eq = equity();
+  peak_equity_ = std::max(peak_equity_, eq);
+  stats_.max_drawdown = std::max(stats_.max_drawdown, peak_equity_ - eq);
+}
+
+const char* describeFillModel(const SimConfig& config) {
+  return config.fill_on_touch
+             ? "on touch, full size, no queue ahead (optimistic)"
+             : "on trade-through, full size, no queue ahead";
+}
+
+template <typename Book>
+void SimExchange::matchBook(Book& book, bool buy) {
+  while (!book.empty()) {
+    auto level = book.begin();
+    double price = Fixed::fromRaw(level->first);
+    bool reached = buy ? (config_.fill_on_touch ? last_ <= price
+                                                : last_ < price)
+                       : (config_.fill_on_touch ? last_ >= price
+                                                : last_ > price);
+    if (!reached) break;
+    // Time priority within the level: oldest order first.
+    for (int64_t id : level->second) {
+      SimOrder& sim = orders_.at(id);
+      fill(sim, static_cast<double>(sim.order.size), price, true);
+    }
+    book.erase(level);
+  }
+}
+
+double SimExchange::reducible(OrderSide side) const {
+  if (side == OrderSide::kBuy) return std::max(0.0, -stats_.position);
+  if (side == OrderSide::kSell) return std::max(0.0, stats_.position);
+  return 0.0;
+}
+
+double SimExchange::fill(SimOrder& sim, double qty, double price,
+                         bool maker) {
+  Order& order = sim.order;
+  if (order.is_reduce_only) qty = std::min(qty, reducible(order.side));
+  if (qty <= 0) {
+    order.status = OrderStatus::kCanceled;
+    return 0.0;
+  }
+
+  double& pos = stats_.position;
+  double signed_qty = order.side == OrderSide::kBuy ? qty : -qty;
+  if (pos == 0 || (pos > 0) == (signed_qty > 0)) {
+    avg_price_ = (avg_price_ * std::fabs(pos) + price * qty) /
+                 (std::fabs(pos) + qty);
+  } else {
+    double closed = std::min(qty, std::fabs(pos));
+    stats_.realized_pnl += closed * (price - avg_price_) * (pos > 0 ? 1 : -1);
+    if (qty > closed) avg_price_ = price;  // flipped through zero
+  }
+  pos += signed_qty;
+  if (std::fabs(pos) < 1e-12) {
+    pos = 0;
+    avg_price_ = 0;
+  }
+
+  double notional = qty * price;
+  stats_.volume += notional;
+  stats_.fees +=
+      notional * (maker ? config_.maker_fee_bps : config_.taker_fee_bps) /
+      10000.0;
+  ++(maker ? stats_.maker_fills : stats_.taker_fills);
+
+  // Whole-order fills only: anything a reduce-only order could not take
+  // off the position is cancelled, as the venue does.
+  sim.filled = qty;
+  order.status = OrderStatus::kFilled;
+  return qty;
+}
+
+void SimExchange::rest(SimOrder& sim) {
+  int64_t key = sim.order.price.raw;
+  if (sim.order.side == OrderSide::kBuy) {
+    bids_[key].push_back(sim.order.id);
+  } else {
+    asks_[key].push_back(sim.order.id);
+  }
+}
+
+void SimExchange::unrest(const SimOrder& sim) {
+  auto remove = [&sim](auto& book) {
+    auto level = book.find(sim.order.price.raw);
+    if (level == book.end()) return;
+    auto& queue = level->second;
+    queue.erase(std::remove(queue.begin(), queue.end(), sim.order.id),
+                queue.end());
+    if (queue.empty()) book.erase(level);
+  };
+  if (sim.order.side == OrderSide::kBuy) {
+    remove(bids_);
+  } else {
+    remove(asks_);
+  }
+}
+
+bool SimExchange::submit(Order& order, bool tp) {
+  // Deterministic client ids keep runs reproducible.
+  ClientOrderId cl_ord_id;
+  uint64_t n = next_client_id_++;
+  for (int i = 0; i < 8; ++i) {
+    cl_ord_id.bytes[i] = static_cast<uint8_t>(n >> (8 * i));
+  }
+  cl_ord_id.bytes[15] = 0x5e;
+  (tp ? order.tpClientId : order.clientId) = cl_ord_id;
+  return submit(order, tp, cl_ord_id);
+}
+
+bool SimExchange::submit(Order& order, bool tp,
+                         const ClientOrderId& cl_ord_id) {
+  ++stats_.place_requests;
+  if (last_ <= 0 || order.size.raw <= 0) return false;
+
+  SimOrder sim;
+  Order& venue = sim.order;
+  venue.id = next_id_++;
+  venue.clientId = cl_ord_id;
+  venue.side = order.side;
+  venue.size = order.size;
+  venue.type = tp ? OrderType::kLimit : order.type;
+  venue.price = tp ? order.tp_price : order.price;
+  venue.is_reduce_only = tp || order.is_reduce_only;
+  bool buy = venue.side == OrderSide::kBuy;
+  venue.positionSide = buy != venue.is_reduce_only ? PositionSide::kLong
+                                                   : PositionSide::kShort;
+  venue.status = OrderStatus::kNew;
+
+  if (venue.is_reduce_only && reducible(venue.side) <= 0) {
+    ++stats_.reduce_only_rejects;
+    venue.status = OrderStatus::kFailed;
+  } else if (venue.type == OrderType::kMarket) {
+    fill(sim, static_cast<double>(venue.size), last_, false);
+  } else if (buy ? static_cast<double>(venue.price) >= last_
+                 : static_cast<double>(venue.price) <= last_) {
+    // Post-only: it would have taken liquidity.
+    ++stats_.alo_rejects;
+    venue.status = OrderStatus::kCanceled;
+  }
+
+  auto inserted = orders_.emplace(venue.id, sim).first;
+  client_ids_[cl_ord_id] = venue.id;
+  if (resting(inserted->second.order)) rest(inserted->second);
+  return true;
+}
+
+bool SimExchange::cancel(int64_t id) {
+  auto it = orders_.find(id);
+  if (it == orders_.end() || !resting(it->second.order)) return false;
+  unrest(it->second);
+  it->second.order.status = OrderStatus::kCanceled;
+  return true;
+}
+
+bool SimExchange::positions(std::vector<Position>& positions_list) {
+  ++stats_.query_requests;
+  // Both sides are reported, the flat one as zero, so a closed position
+  // is seen as closed.
+  positions_list.clear();
+  Position long_pos;
+  long_pos.positionSide = PositionSide::kLong;
+  long_pos.positionAmt = static_cast<float>(std::max(0.0, stats_.position));
+  Position short_pos;
+  short_pos.positionSide = PositionSide::kShort;
+  short_pos.positionAmt = static_cast<float>(std::max(0.0, -stats_.position));
+  positions_list.push_back(long_pos);
+  positions_list.push_back(short_pos);
+  return true;
+}
+
+bool SimExchange::tickers(Ticker& tk) {
+  ++stats_.query_requests;
+  tk.contract = config_.symbol;
+  tk.last = static_cast<float>(last_);
+  return last_ > 0;
+}
+
+bool SimExchange::balance(float& availBal, float& totalBal) {
+  ++stats_.query_requests;
+  availBal = totalBal = static_cast<float>(equity());
+  return true;
+}
+
+bool SimExchange::detail(Order& order) {
+  ++stats_.query_requests;
+  auto it = orders_.find(order.id);
+  if (it == orders_.end()) return false;
+  order.status = it->second.order.status;
+  return true;
+}
+
+bool SimExchange::detailByClientId(Order& order) {
+  ++stats_.query_requests;
+  auto it = client_ids_.find(order.clientId);
+  if (it == client_ids_.end()) return false;
+  order.id = it->second;
+  order.status = orders_.at(it->second).order.status;
+  return true;
+}
+
+std::future<bool> SimExchange::detailByClientIdAsync(Order& order) {
+  return ready(detailByClientId(order));
+}
+
+bool SimExchange::unfilledOrders(std::vector<Order>& order_list) {
+  ++stats_.query_requests;
+  order_list.clear();
+  for (const auto& level : bids_) {
+    for (int64_t id : level.second) order_list.push_back(orders_.at(id).order);
+  }
+  for (const auto& level : asks_) {
+    for (int64_t id : level.second) order_list.push_back(orders_.at(id).order);
+  }
+  return true;
+}
+
+bool SimExchange::placeOrder(Order& order) { return submit(order, false); }
+
+bool SimExchange::placeOrder(Order& order, const ClientOrderId& cl_ord_id) {
+  if (client_ids_.count(cl_ord_id) != 0) return false;
+  order.clientId = cl_ord_id;
+  if (!submit(order, false, cl_ord_id)) return false;
+  order.id = client_ids_[cl_ord_id];
+  return true;
+}
+
+std::future<bool> SimExchange::placeOrderAsync(Order& order) {
+  return ready(submit(order, false));
+}
+
+std::future<bool> SimExchange::tpOrderAsync(Order& order) {
+  return ready(submit(order, true));
+}
+
+std::future<AmendStatus> SimExchange::amendOrderAsync(int64_t id,
+                                                      Order& order,
+                                                      bool tp) {
+  ++stats_.amend_requests;
+  if (!cancel(id)) return ready(AmendStatus::kRejected);
+  return ready(submit(order, tp) ? AmendStatus::kAmended
+                                 : AmendStatus::kReplaceFailed);
+}
+
+std::vector<bool> SimExchange::cancelOrders(const std::vector<int64_t>& ids,
+                                            std::vector<int64_t>* filled) {
+  stats_.cancel_requests += ids.size();
+  std::vector<bool> results;
+  results.reserve(ids.size());
+  for (int64_t id : ids) {
+    results.push_back(cancel(id));
+    auto it = orders_.find(id);
+    if (!results.back() && filled != nullptr && it != orders_.end() &&
+        it->second.order.status == OrderStatus::kFilled) {
+      filled->push_back(id);
+    }
+  }
+  return results;
+}
+
+}  // namespace standx
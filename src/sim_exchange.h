@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "data.h"
+#include "exchange.h"
+
+namespace standx {
+
+struct SimConfig {
+    std::string symbol{"BTC-USD"};
+    double initial_balance{10000.0};
+    double maker_fee_bps{0.0};
+    double taker_fee_bps{5.0};
+    // A resting order fills when the price touches its limit; otherwise the
+    // price has to trade through it (the conservative queue assumption).
+    bool fill_on_touch{false};
+};
+
+// Order traffic and results of a simulated run.
+struct SimStats {
+    uint64_t place_requests{0};   // new orders, including TP and market
+    uint64_t cancel_requests{0};  // order ids asked to cancel
+    uint64_t amend_requests{0};
+    uint64_t query_requests{0};   // detail, open orders, positions, ...
+    uint64_t alo_rejects{0};      // post-only orders that would have crossed
+    uint64_t reduce_only_rejects{0};
+    uint64_t maker_fills{0};
+    uint64_t taker_fills{0};
+    double volume{0.0};           // traded notional
+    double fees{0.0};
+    double realized_pnl{0.0};     // before fees
+    double unrealized_pnl{0.0};   // open position marked at the last price
+    double max_drawdown{0.0};     // peak-to-trough equity drop
+    double position{0.0};         // signed net position at the end
+};
+
+// One line stating the fill assumptions of config, for reports.
+const char* describeFillModel(const SimConfig& config);
+
+// In-process venue for one symbol, driven by a replayed price series.
+//
+// Matching follows StandX: one net position, limit orders are post-only
+// (ALO) and rejected if they would cross, market orders are IOC and fill
+// at the last price, reduce-only orders may only shrink the position.
+// Resting orders fill in price-time priority as the price reaches them.
+//
+// The fill model is optimistic: the replay carries prices only, so there
+// is no queue ahead of our orders and no partial fills. Every order at a
+// level the price reaches fills completely at once, whatever the size
+// traded there. Results are an upper bound on maker fills; --touch makes
+// them more so. describeFillModel() states this for tool output.
+//
+// Every call settles instantly and futures are returned ready. Not
+// thread-safe; drive it and its Strategy from one thread.
+class SimExchange : public Exchange {
+public:
+    explicit SimExchange(const SimConfig& config);
+
+    // Advance to the next tick: update the last price, fill whatever it
+    // reaches and mark equity.
+    void onTick(int64_t ts_ms, double price);
+
+    const SimStats& stats() const { return stats_; }
+    double equity() const;
+    int64_t now_ms() const { return now_ms_; }
+
+    std::string getInstId() const override { return config_.symbol; }
+    bool positions(std::vector<Position>& positions_list) override;
+    bool tickers(Ticker& tk) override;
+    bool balance(float& availBal, float& totalBal) override;
+    bool detail(Order& order) override;
+    bool detailByClientId(Order& order) override;
+    std::future<bool> detailByClientIdAsync(Order& order) override;
+    bool unfilledOrders(std::vector<Order>& order_list) override;
+    bool placeOrder(Order& order) override;
+    std::future<bool> placeOrderAsync(Order& order) override;
+    std::future<bool> tpOrderAsync(Order& order) override;
+    std::future<AmendStatus> amendOrderAsync(int64_t id, Order& order,
+                                             bool tp) override;
+    std::vector<bool> cancelOrders(
+        const std::vector<int64_t>& ids,
+        std::vector<int64_t>* filled = nullptr) override;
+    void sleep(int ms) override { (void)ms; }
+
+    // Place with a client id the caller picked, as API clients do; a TP
+    // arrives this way as a plain reduce-only limit. Sets order.id. False
+    // if the id is already taken.
+    bool placeOrder(Order& order, const ClientOrderId& cl_ord_id);
+
+private:
+    struct SimOrder {
+        Order order;  // as submitted, with the venue's id and status
+        Fixed filled;
+    };
+    // Best price first: bids descending, asks ascending. Each level queues
+    // order ids in arrival order, which gives time priority.
+    using BidBook = std::map<int64_t, std::deque<int64_t>,
+                             std::greater<int64_t>>;
+    using AskBook = std::map<int64_t, std::deque<int64_t>>;
+
+    bool submit(Order& order, bool tp);
+    bool submit(Order& order, bool tp, const ClientOrderId& cl_ord_id);
+    bool cancel(int64_t id);
+    void rest(SimOrder& sim);
+    void unrest(const SimOrder& sim);
+    template <typename Book>
+    void matchBook(Book& book, bool buy);
+    // Fill up to qty of sim at price; reduce-only orders are clipped to the
+    // position and cancelled beyond it. Returns the filled quantity.
+    double fill(SimOrder& sim, double qty, double price, bool maker);
+    // Quantity a reduce-only order on side may still take off the position.
+    double reducible(OrderSide side) const;
+
+    SimConfig config_;
+    SimStats stats_;
+    int64_t now_ms_{0};
+    double last_{0.0};
+    double avg_price_{0.0};
+    double peak_equity_{0.0};
+    int64_t next_id_{1};
+    uint64_t next_client_id_{1};
+    std::unordered_map<int64_t, SimOrder> orders_;
+    std::unordered_map<ClientOrderId, int64_t, ClientOrderIdHash> client_ids_;
+    BidBook bids_;
+    AskBook asks_;
+};
+
+}  // namespace standx
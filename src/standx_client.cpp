@@ -1,60 +1,297 @@
 #include "standx_client.h"
 
 #include <algorithm>
-#include <chrono>
-#include <iomanip>
+#include <cstdlib>
+#include <cstring>
 #include <nlohmann/json.hpp>
-#include <random>
-#include <sstream>
+#include <optional>
 #include <stdexcept>
 
+#include "async_http_client.h"
 #include "auth.h"
 #include "http_client.h"
+#include "json_scanner.h"
+#include "latency.h"
+#include "request_signer.h"
+#include "sign_worker.h"
 #include "tracer.h"
 #include "util.h"
 
 namespace standx {
 
-static std::string mapOrderStatus(const std::string& api_status) {
-  if (api_status == "open") return "NEW";
-  if (api_status == "canceled") return "CANCELED";
-  if (api_status == "filled") return "FILLED";
-  if (api_status == "rejected") return "FAILED";
-  return "UNKNOWN";
+namespace {
+
+// Exact decimal string to Fixed, without going through float. Digits past
+// the 8th decimal are truncated; anything unparsable yields zero.
+Fixed parseFixed(std::string_view text) {
+  int64_t int_part = 0;
+  int64_t frac_part = 0;
+  int64_t frac_scale = Fixed::kScale;
+  bool negative = false;
+  bool in_frac = false;
+  size_t i = 0;
+  if (i < text.size() && (text[i] == '-' || text[i] == '+')) {
+    negative = text[i] == '-';
+    ++i;
+  }
+  for (; i < text.size(); ++i) {
+    char c = text[i];
+    if (c == '.' && !in_frac) {
+      in_frac = true;
+    } else if (c >= '0' && c <= '9') {
+      if (!in_frac) {
+        int_part = int_part * 10 + (c - '0');
+      } else if (frac_scale > 1) {
+        frac_scale /= 10;
+        frac_part += (c - '0') * frac_scale;
+      }
+    } else {
+      return Fixed();
+    }
+  }
+  int64_t raw = int_part * Fixed::kScale + frac_part;
+  return Fixed::fromRaw(negative ? -raw : raw);
+}
+
+// Decimal text to float through a stack copy; 0 when unparsable.
+float parseFloat(std::string_view text) {
+  char buffer[64];
+  if (text.empty() || text.size() >= sizeof(buffer)) return 0.0f;
+  memcpy(buffer, text.data(), text.size());
+  buffer[text.size()] = '\0';
+  char* end = nullptr;
+  float value = strtof(buffer, &end);
+  return end == buffer ? 0.0f : value;
+}
+
+// Response schemas. Bodies are decoded by JsonScanner straight into these
+// structs (or Order), with no DOM and no allocation past the caller's
+// vectors. As before, members of an unexpected type are ignored.
+
+// Calls apply(text) when the value is a string and skips anything else.
+template <typename F>
+bool ifString(JsonScanner& scanner, F&& apply) {
+  if (scanner.peek() != JsonScanner::Type::kString) return scanner.skip();
+  std::string_view text;
+  if (!scanner.string(text)) return false;
+  apply(text);
+  return true;
+}
+
+// Ids arrive as JSON numbers or as numeric strings.
+bool readId(JsonScanner& scanner, int64_t& id) {
+  JsonScanner::Type type = scanner.peek();
+  if (type != JsonScanner::Type::kNumber &&
+      type != JsonScanner::Type::kString) {
+    return scanner.skip();
+  }
+  return scanner.integer(id);
+}
+
+struct BalanceReply {
+  float available;
+  float total;
+};
+
+const JsonField<BalanceReply> kBalanceSchema[] = {
+    {"cross_available",
+     [](JsonScanner& s, BalanceReply& r) {
+       return ifString(s, [&](std::string_view t) {
+         r.available = parseFloat(t);
+       });
+     }},
+    {"cross_balance",
+     [](JsonScanner& s, BalanceReply& r) {
+       return ifString(s, [&](std::string_view t) { r.total = parseFloat(t); });
+     }},
+};
+
+const JsonField<Position> kPositionSchema[] = {
+    {"qty",
+     [](JsonScanner& s, Position& p) {
+       return ifString(s, [&](std::string_view t) {
+         float qty = parseFloat(t);
+         p.positionSide = qty < 0 ? PositionSide::kShort : PositionSide::kLong;
+         p.positionAmt = qty < 0 ? -qty : qty;
+       });
+     }},
+};
+
+struct DetailReply {
+  int64_t id;
+  OrderStatus status;
+};
+
+const JsonField<DetailReply> kDetailSchema[] = {
+    {"id", [](JsonScanner& s, DetailReply& r) { return readId(s, r.id); }},
+    {"status",
+     [](JsonScanner& s, DetailReply& r) {
+       return ifString(s, [&](std::string_view t) {
+         r.status = mapOrderStatus(t);
+       });
+     }},
+};
+
+const JsonField<Order> kOpenOrderSchema[] = {
+    {"id", [](JsonScanner& s, Order& o) { return readId(s, o.id); }},
+    {"cl_ord_id",
+     [](JsonScanner& s, Order& o) {
+       // Orders placed elsewhere may carry a non-UUID id; left empty.
+       return ifString(s, [&](std::string_view t) {
+         parseClientOrderId(t, o.clientId);
+       });
+     }},
+    {"side",
+     [](JsonScanner& s, Order& o) {
+       return ifString(s, [&](std::string_view t) {
+         o.side = parseOrderSide(t);
+       });
+     }},
+    {"qty",
+     [](JsonScanner& s, Order& o) {
+       return ifString(s, [&](std::string_view t) { o.size = parseFixed(t); });
+     }},
+    {"price",
+     [](JsonScanner& s, Order& o) {
+       return ifString(s, [&](std::string_view t) { o.price = parseFixed(t); });
+     }},
+    {"reduce_only",
+     [](JsonScanner& s, Order& o) {
+       if (s.peek() != JsonScanner::Type::kBool) return s.skip();
+       return s.boolean(o.is_reduce_only);
+     }},
+    {"status",
+     [](JsonScanner& s, Order& o) {
+       return ifString(s, [&](std::string_view t) {
+         o.status = mapOrderStatus(t);
+       });
+     }},
+};
+
+// A string member of a top-level object, e.g. "last_price" or "message".
+struct TextReply {
+  std::string_view text;
+  bool found;
+};
+
+bool decodeText(JsonScanner& scanner, std::string_view key,
+                TextReply& reply) {
+  if (scanner.peek() != JsonScanner::Type::kObject) return scanner.skip();
+  return scanner.object([&](std::string_view k) {
+    if (k != key) return scanner.skip();
+    return ifString(scanner, [&](std::string_view t) {
+      reply.text = t;
+      reply.found = true;
+    });
+  });
+}
+
+// Decodes the whole body with decode; malformed JSON throws, so it takes
+// the callers' existing error paths.
+template <typename F>
+void scanResponse(const std::string& body, F&& decode) {
+  JsonScanner scanner(body);
+  if (!decode(scanner) || !scanner.finished()) {
+    throw std::runtime_error("malformed JSON response");
+  }
+}
+
+// True when the reply carries "message": "success", as new_order and the
+// cancel endpoints answer when they acted; a 2xx alone does not say so.
+// Otherwise why holds the reason, for the log.
+bool acknowledged(const HttpResponse& resp, std::string& why) {
+  if (!resp.ok()) {
+    why = "code " + std::to_string(resp.code) + " " + resp.error;
+    return false;
+  }
+  TextReply reply{};
+  try {
+    scanResponse(resp.body, [&](JsonScanner& s) {
+      return decodeText(s, "message", reply);
+    });
+  } catch (const std::exception& e) {
+    why = e.what();
+    return false;
+  }
+  if (reply.found && reply.text == "success") return true;
+  why = reply.found ? std::string(reply.text) : resp.body;
+  return false;
+}
+
+// Stage histograms of order submission, looked up once.
+struct OrderLatency {
+  LatencyRegistry& r = LatencyRegistry::instance();
+  LatencyHistogram& decision_to_signed = r.get("order decision_to_signed");
+  LatencyHistogram& signed_to_sent = r.get("order signed_to_sent");
+  LatencyHistogram& sent_to_response = r.get("order sent_to_response");
+  LatencyHistogram& response_to_parsed = r.get("order response_to_parsed");
+  LatencyHistogram& tick_to_wire = r.get("order tick_to_wire");
+  LatencyHistogram& tick_to_ack = r.get("order tick_to_ack");
+};
+
+OrderLatency& orderLatency() {
+  static OrderLatency latency;
+  return latency;
+}
+
+}  // namespace
+
+OrderStatus mapOrderStatus(std::string_view api_status) {
+  if (api_status == "open") return OrderStatus::kNew;
+  if (api_status == "canceled") return OrderStatus::kCanceled;
+  if (api_status == "filled") return OrderStatus::kFilled;
+  if (api_status == "rejected") return OrderStatus::kFailed;
+  return OrderStatus::kUnknown;
+}
+
+OrderSide parseOrderSide(std::string_view side) {
+  if (side == "buy" || side == "BUY") return OrderSide::kBuy;
+  if (side == "sell" || side == "SELL") return OrderSide::kSell;
+  return OrderSide::kNone;
+}
+
+std::string formatClientOrderId(const ClientOrderId& id) {
+  std::string text(RequestSigner::kIdTextSize, '-');
+  RequestSigner::formatId(id, &text[0]);
+  return text;
+}
+
+bool parseClientOrderId(std::string_view text, ClientOrderId& out) {
+  return RequestSigner::parseId(text, out);
 }
 
 StandXClient::StandXClient(const std::string& chain,
                            const std::string& private_key_hex,
                            const std::string& symbol)
-    : chain_(chain),
+    : StandXClient(std::make_shared<Session>(chain, private_key_hex),
+                   symbol) {}
+
+StandXClient::StandXClient(std::shared_ptr<Session> session,
+                           const std::string& symbol)
+    : session_(std::move(session)),
       symbol_(symbol),
-      api_base_url_("https://perps.standx.com") {
-  http_ = std::make_unique<HttpClient>();
-  auth_ = std::make_unique<AuthManager>(chain);
-  auth_->set_private_key(private_key_hex);
-  access_token_ = auth_->login();
-
-  http_->set_token_refresh_callback([this]() {
-    access_token_ = auth_->login();
-    return access_token_;
-  });
-}
+      api_base_url_(session_->endpoints().api) {}
 
 StandXClient::~StandXClient() = default;
 
-std::string StandXClient::get_address() const { return auth_->get_address(); }
+std::string StandXClient::get_address() const { return session_->address(); }
+
+std::string StandXClient::login() { return session_->login(); }
+
+std::string StandXClient::get_access_token() const {
+  return session_->access_token();
+}
 
-std::string StandXClient::login() {
-  access_token_ = auth_->login();
-  return access_token_;
+AuthManager* StandXClient::get_auth_manager() const {
+  return &session_->auth();
 }
 
 std::string StandXClient::request_with_retry(const std::string& url) {
-  return http_->get_with_auth(url, access_token_);
+  return session_->http().get_with_auth(url, get_access_token());
 }
 
 bool StandXClient::balance(float& availBal, float& totalBal) {
-  if (access_token_.empty()) {
+  if (get_access_token().empty()) {
     throw std::runtime_error("not logged in, call login() first");
   }
 
@@ -62,15 +299,13 @@ bool StandXClient::balance(float& availBal, float& totalBal) {
 
   try {
     std::string response = request_with_retry(url);
-    auto json = nlohmann::json::parse(response);
-
-    if (json.contains("cross_available") &&
-        json["cross_available"].is_string()) {
-      availBal = safeStof(json["cross_available"].get<std::string>());
-    }
-    if (json.contains("cross_balance") && json["cross_balance"].is_string()) {
-      totalBal = safeStof(json["cross_balance"].get<std::string>());
-    }
+    BalanceReply reply{availBal, totalBal};
+    scanResponse(response, [&](JsonScanner& s) {
+      if (s.peek() != JsonScanner::Type::kObject) return s.skip();
+      return decodeObject(s, reply, kBalanceSchema);
+    });
+    availBal = reply.available;
+    totalBal = reply.total;
 
     return true;
   } catch (const std::exception& e) {
@@ -80,7 +315,7 @@ bool StandXClient::balance(float& availBal, float& totalBal) {
 }
 
 bool StandXClient::positions(std::vector<Position>& positions_list) {
-  if (access_token_.empty()) {
+  if (get_access_token().empty()) {
     throw std::runtime_error("not logged in, call login() first");
   }
 
@@ -91,30 +326,20 @@ bool StandXClient::positions(std::vector<Position>& positions_list) {
 
   try {
     std::string response = request_with_retry(url);
-    auto json = nlohmann::json::parse(response);
 
     positions_list.clear();
-
-    if (json.is_array()) {
-      for (const auto& item : json) {
+    scanResponse(response, [&](JsonScanner& s) {
+      if (s.peek() != JsonScanner::Type::kArray) return s.skip();
+      return s.array([&] {
         Position pos;
-
-        float qty = 0.0f;
-        if (item.contains("qty") && item["qty"].is_string()) {
-          qty = safeStof(item["qty"].get<std::string>());
-        }
-
-        if (qty < 0) {
-          pos.positionSide = "SHORT";
-          pos.positionAmt = -qty;
-        } else {
-          pos.positionSide = "LONG";
-          pos.positionAmt = qty;
-        }
-
-        positions_list.push_back(pos);
-      }
-    }
+        pos.positionSide = PositionSide::kLong;
+        bool ok = s.peek() == JsonScanner::Type::kObject
+                      ? decodeObject(s, pos, kPositionSchema)
+                      : s.skip();
+        if (ok) positions_list.push_back(pos);
+        return ok;
+      });
+    });
 
     return true;
   } catch (const std::exception& e) {
@@ -123,40 +348,86 @@ bool StandXClient::positions(std::vector<Position>& positions_list) {
   }
 }
 
-bool StandXClient::detail(Order& order) {
-  if (order.id.empty()) {
+std::future<bool> StandXClient::detailAsync(Order& order) {
+  auto promise = std::make_shared<std::promise<bool>>();
+  std::future<bool> future = promise->get_future();
+
+  if (order.id == 0) {
     ERROR("Order ID is empty");
-    order.status = "FAILED";
-    return true;
+    order.status = OrderStatus::kFailed;
+    promise->set_value(true);
+    return future;
   }
-  if (access_token_.empty()) {
+  if (get_access_token().empty()) {
     throw std::runtime_error("not logged in, call login() first");
   }
 
-  if (order.id.empty()) {
-    ERROR("Order id is required for detail query");
-    return false;
-  }
+  std::string url =
+      api_base_url_ + "/api/query_order?order_id=" + std::to_string(order.id);
+  std::vector<std::string> headers{"Accept: application/json"};
+
+  submitWithAuth("GET", url, "", headers, [promise, &order](HttpResponse& resp) {
+    try {
+      if (!resp.error.empty()) throw std::runtime_error(resp.error);
+      DetailReply reply{0, order.status};
+      scanResponse(resp.body, [&](JsonScanner& s) {
+        if (s.peek() != JsonScanner::Type::kObject) return s.skip();
+        return decodeObject(s, reply, kDetailSchema);
+      });
+      order.status = reply.status;
+      promise->set_value(true);
+    } catch (const std::exception& e) {
+      ERROR("Error parsing order detail response: " << e.what());
+      promise->set_value(false);
+    }
+  });
+  return future;
+}
 
-  std::string url = api_base_url_ + "/api/query_order?order_id=" + order.id;
+bool StandXClient::detail(Order& order) { return detailAsync(order).get(); }
 
-  try {
-    std::string response = request_with_retry(url);
-    auto json = nlohmann::json::parse(response);
+bool StandXClient::detailByClientId(Order& order) {
+  return detailByClientIdAsync(order).get();
+}
 
-    if (json.contains("status") && json["status"].is_string()) {
-      order.status = mapOrderStatus(json["status"].get<std::string>());
-    }
+std::future<bool> StandXClient::detailByClientIdAsync(Order& order) {
+  auto promise = std::make_shared<std::promise<bool>>();
+  std::future<bool> future = promise->get_future();
 
-    return true;
-  } catch (const std::exception& e) {
-    ERROR("Error parsing order detail response: " << e.what());
-    return false;
+  if (order.clientId.empty()) {
+    ERROR("Client order id is required for detail query");
+    promise->set_value(false);
+    return future;
+  }
+  if (get_access_token().empty()) {
+    throw std::runtime_error("not logged in, call login() first");
   }
+
+  std::string url = api_base_url_ + "/api/query_order?cl_ord_id=" +
+                    formatClientOrderId(order.clientId);
+  std::vector<std::string> headers{"Accept: application/json"};
+
+  submitWithAuth("GET", url, "", headers, [promise, &order](HttpResponse& resp) {
+    try {
+      if (!resp.error.empty()) throw std::runtime_error(resp.error);
+      DetailReply reply{0, order.status};
+      scanResponse(resp.body, [&](JsonScanner& s) {
+        if (s.peek() != JsonScanner::Type::kObject) return s.skip();
+        return decodeObject(s, reply, kDetailSchema);
+      });
+      order.id = reply.id;
+      order.status = reply.status;
+      promise->set_value(order.id != 0);
+    } catch (const std::exception& e) {
+      ERROR("Error parsing order detail response: " << e.what());
+      promise->set_value(false);
+    }
+  });
+  return future;
 }
 
-bool StandXClient::unfilledOrders(std::list<Order>& order_list) {
-  if (access_token_.empty()) {
+bool StandXClient::unfilledOrders(std::vector<Order>& order_list) {
+  if (get_access_token().empty()) {
     throw std::runtime_error("not logged in, call login() first");
   }
 
@@ -167,57 +438,37 @@ bool StandXClient::unfilledOrders(std::list<Order>& order_list) {
 
   try {
     std::string response = request_with_retry(url);
-    auto json = nlohmann::json::parse(response);
 
     order_list.clear();
-
-    if (json.contains("result") && json["result"].is_array()) {
-      for (const auto& item : json["result"]) {
-        Order order;
-
-        if (item.contains("id") && item["id"].is_number()) {
-          order.id = std::to_string(item["id"].get<long long>());
-        }
-
-        if (item.contains("side") && item["side"].is_string()) {
-          std::string side = item["side"].get<std::string>();
-          std::transform(side.begin(), side.end(), side.begin(), ::toupper);
-          order.side = side;
-        }
-
-        if (item.contains("qty") && item["qty"].is_string()) {
-          order.size = safeStof(item["qty"].get<std::string>());
-        }
-
-        if (item.contains("price") && item["price"].is_string()) {
-          order.price = safeStof(item["price"].get<std::string>());
-        }
-
-        if (item.contains("reduce_only") && item["reduce_only"].is_boolean()) {
-          order.is_reduce_only = item["reduce_only"].get<bool>();
-        }
-
-        if (item.contains("status") && item["status"].is_string()) {
-          order.status = mapOrderStatus(item["status"].get<std::string>());
+    scanResponse(response, [&](JsonScanner& s) {
+      if (s.peek() != JsonScanner::Type::kObject) return s.skip();
+      return s.object([&](std::string_view key) {
+        if (key != "result" || s.peek() != JsonScanner::Type::kArray) {
+          return s.skip();
         }
-
-        if (order.is_reduce_only) {
-          if (order.side == "SELL") {
-            order.positionSide = "LONG";
-          } else if (order.side == "BUY") {
-            order.positionSide = "SHORT";
-          }
-        } else {
-          if (order.side == "BUY") {
-            order.positionSide = "LONG";
-          } else if (order.side == "SELL") {
-            order.positionSide = "SHORT";
+        return s.array([&] {
+          if (s.peek() != JsonScanner::Type::kObject) return s.skip();
+          order_list.emplace_back();
+          Order& order = order_list.back();
+          if (!decodeObject(s, order, kOpenOrderSchema)) return false;
+
+          if (order.is_reduce_only) {
+            if (order.side == OrderSide::kSell) {
+              order.positionSide = PositionSide::kLong;
+            } else if (order.side == OrderSide::kBuy) {
+              order.positionSide = PositionSide::kShort;
+            }
+          } else {
+            if (order.side == OrderSide::kBuy) {
+              order.positionSide = PositionSide::kLong;
+            } else if (order.side == OrderSide::kSell) {
+              order.positionSide = PositionSide::kShort;
+            }
           }
-        }
-
-        order_list.push_back(order);
-      }
-    }
+          return true;
+        });
+      });
+    });
 
     return true;
   } catch (const std::exception& e) {
@@ -230,11 +481,14 @@ bool StandXClient::tickers(Ticker& tk) {
   std::string url = api_base_url_ + "/api/query_symbol_price?symbol=" + symbol_;
 
   try {
-    std::string response = http_->get(url);
-    auto json = nlohmann::json::parse(response);
-
-    if (json.contains("last_price") && json["last_price"].is_string()) {
-      tk.last = safeStof(json["last_price"]);
+    std::string response = session_->http().get(url);
+    TextReply reply{};
+    scanResponse(response, [&](JsonScanner& s) {
+      return decodeText(s, "last_price", reply);
+    });
+
+    if (reply.found) {
+      tk.last = parseFloat(reply.text);
       return true;
     }
 
@@ -246,215 +500,443 @@ bool StandXClient::tickers(Ticker& tk) {
   }
 }
 
-bool StandXClient::placeOrder(Order& order) {
-  if (access_token_.empty()) {
-    throw std::runtime_error("not logged in, call login() first");
-  }
+ClientOrderId StandXClient::newClientOrderId() {
+  return RequestSigner::local().newId();
+}
 
+void StandXClient::submitSigned(const std::string& url, std::string body,
+                                AsyncHttpClient::Callback callback) {
+  ClientOrderId request_id = newClientOrderId();
+  session_->signer().submit(
+      request_id,
+      [body = std::move(body)]() mutable { return std::move(body); },
+      [this, url, callback, request_id](const std::string& signed_body,
+                                        std::vector<std::string>& headers,
+                                        const std::string& error) {
+        if (!error.empty()) {
+          HttpResponse resp;
+          resp.error = error;
+          callback(resp);
+          return;
+        }
+        submitWithAuth("POST", url, signed_body, headers, callback,
+                       &request_id);
+      });
+}
+
+void StandXClient::submitWithAuth(const std::string& method,
+                                  const std::string& url,
+                                  const std::string& body,
+                                  const std::vector<std::string>& headers,
+                                  AsyncHttpClient::Callback callback,
+                                  const ClientOrderId* request_id,
+                                  bool retry_on_401) {
+  std::string token = get_access_token();
+  std::vector<std::string> all_headers;
+  all_headers.reserve(headers.size() + 1);
+  all_headers.push_back("Authorization: Bearer " + token);
+  all_headers.insert(all_headers.end(), headers.begin(), headers.end());
+
+  std::optional<ClientOrderId> signed_id;
+  if (request_id != nullptr) signed_id = *request_id;
+  session_->async_http().submit(
+      method, url, all_headers, body,
+      [this, method, url, body, headers, callback, signed_id, token,
+       retry_on_401](HttpResponse& resp) {
+        if (!retry_on_401 || resp.code != 401) {
+          callback(resp);
+          return;
+        }
+        // This runs on the event loop, so the login goes to the signer.
+        // Requests that failed together share one refresh: only the first
+        // job still sees the expired token.
+        HttpResponse failed = resp;
+        session_->signer().submit(
+            signed_id ? *signed_id : newClientOrderId(),
+            [this, body, token]() {
+              if (get_access_token() == token) login();
+              return body;
+            },
+            [this, method, url, headers, callback, signed_id, failed](
+                const std::string& signed_body,
+                std::vector<std::string>& signed_headers,
+                const std::string& error) {
+              if (!error.empty()) {
+                ERROR("Token refresh failed: " << error);
+                HttpResponse resp = failed;
+                callback(resp);
+                return;
+              }
+              submitWithAuth(method, url, signed_body,
+                             signed_id ? signed_headers : headers, callback,
+                             signed_id ? &*signed_id : nullptr, false);
+            });
+      });
+}
+
+std::string StandXClient::orderBody(const Order& order, bool tp) const {
   nlohmann::json order_json;
   order_json["symbol"] = symbol_;
 
-  std::string side = order.side;
-  std::transform(side.begin(), side.end(), side.begin(), ::tolower);
-  order_json["side"] = side;
-
-  std::string type = order.type;
-  std::transform(type.begin(), type.end(), type.begin(), ::tolower);
-  order_json["order_type"] = type;
-  order_json["qty"] = std::to_string(order.size);
-  order_json["reduce_only"] = order.is_reduce_only;
+  order_json["side"] = order.side == OrderSide::kBuy ? "buy" : "sell";
+  bool market = order.type == OrderType::kMarket;
+  order_json["order_type"] = market ? "market" : "limit";
+  order_json["qty"] = std::to_string(static_cast<double>(order.size));
+  const ClientOrderId& cl_ord_id = tp ? order.tpClientId : order.clientId;
+  if (!cl_ord_id.empty()) {
+    order_json["cl_ord_id"] = formatClientOrderId(cl_ord_id);
+  }
 
-  if (type == "market") {
-    order_json["time_in_force"] = "ioc";
-  } else {
+  if (tp) {
     order_json["time_in_force"] = "alo";
-    order_json["price"] = safeFtos(order.price, PRICE_ACCURACY_INT);
+    order_json["reduce_only"] = true;
+    order_json["price"] = safeFtos(order.tp_price, PRICE_ACCURACY_INT);
+  } else {
+    order_json["reduce_only"] = order.is_reduce_only;
+    if (market) {
+      order_json["time_in_force"] = "ioc";
+    } else {
+      order_json["time_in_force"] = "alo";
+      order_json["price"] = safeFtos(order.price, PRICE_ACCURACY_INT);
+    }
+  }
+  return order_json.dump();
+}
+
+void StandXClient::submitOrder(Order& order, bool tp,
+                               std::function<void(bool)> done) {
+  if (get_access_token().empty()) {
+    throw std::runtime_error("not logged in, call login() first");
   }
 
   std::string url = api_base_url_ + "/api/new_order";
-  std::string body = order_json.dump();
-
-  std::random_device rd;
-  std::mt19937_64 gen(rd());
-  std::uniform_int_distribution<uint64_t> dis;
-
-  std::stringstream ss;
-  ss << std::hex << std::setfill('0') << std::setw(8) << (dis(gen) & 0xFFFFFFFF)
-     << "-" << std::setw(4) << (dis(gen) & 0xFFFF) << "-" << std::setw(4)
-     << ((dis(gen) & 0x0FFF) | 0x4000) << "-" << std::setw(4)
-     << ((dis(gen) & 0x3FFF) | 0x8000) << "-" << std::setw(12)
-     << (dis(gen) & 0xFFFFFFFFFFFF);
-  std::string request_id = ss.str();
-
-  auto now = std::chrono::system_clock::now();
-  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                now.time_since_epoch())
-                .count();
-  std::string timestamp = std::to_string(ms);
-
-  std::string version = "v1";
-  std::string message =
-      version + "," + request_id + "," + timestamp + "," + body;
-
-  std::string signature = auth_->sign_ed25519_base64(message);
-  std::map<std::string, std::string> extra_headers;
-  extra_headers["x-request-sign-version"] = version;
-  extra_headers["x-request-id"] = request_id;
-  extra_headers["x-request-timestamp"] = timestamp;
-  extra_headers["x-request-signature"] = signature;
+  // The request id doubles as the client order id, so the exchange order
+  // can be looked up directly instead of being matched by price.
+  ClientOrderId cl_ord_id = newClientOrderId();
+  (tp ? order.tpClientId : order.clientId) = cl_ord_id;
+  TickTrace trace = currentTickTrace();
+  const char* what = tp ? "TP order" : "Order";
+
+  // The body is built and signed on the session's signer thread; this
+  // thread only queues the order.
+  session_->signer().submit(
+      cl_ord_id, [this, &order, tp]() { return orderBody(order, tp); },
+      [this, url, done, what, &order, trace, cl_ord_id](
+          const std::string& body, std::vector<std::string>& headers,
+          const std::string& error) {
+        if (!error.empty()) {
+          done(false);
+          return;
+        }
+        int64_t signed_ns = monoNowNs();
+        if (trace.decision_ns != 0) {
+          orderLatency().decision_to_signed.record(signed_ns -
+                                                   trace.decision_ns);
+        }
+        submitOrderSigned(url, body, headers, cl_ord_id, what, order,
+                          signed_ns, trace, done);
+      });
+}
 
-  try {
-    std::string response =
-        http_->post_json_with_auth(url, body, access_token_, extra_headers);
-
-    auto json_response = nlohmann::json::parse(response);
-        if (json_response.contains("message") &&
-            json_response["message"].is_string()) {
-          std::string msg = json_response["message"].get<std::string>();
-          if (msg == "success") {
-            DEBUG("Order placed ok: " << order.id);
-            return true;
-          } else {
-            DEBUG("Order placement returned message: " << msg);
+void StandXClient::submitOrderSigned(const std::string& url,
+                                     const std::string& body,
+                                     const std::vector<std::string>& headers,
+                                     const ClientOrderId& request_id,
+                                     const char* what, Order& order,
+                                     int64_t signed_ns, TickTrace trace,
+                                     std::function<void(bool)> done) {
+  submitWithAuth(
+      "POST", url, body, headers,
+      [done, what, &order, signed_ns, trace](HttpResponse& resp) {
+        bool ok = false;
+        try {
+          if (!resp.error.empty()) {
+            throw std::runtime_error(resp.error);
+          }
+          TextReply reply{};
+          scanResponse(resp.body, [&](JsonScanner& s) {
+            return decodeText(s, "message", reply);
+          });
+          if (reply.found) {
+            if (reply.text == "success") {
+              DEBUG(what << " placed ok: " << order.id);
+              ok = true;
+            } else {
+              DEBUG(what << " placement returned message: " << reply.text);
+            }
           }
+        } catch (const std::exception& e) {
+          ERROR("Failed to place " << what << ": " << e.what());
         }
-  } catch (const std::exception& e) {
-    ERROR("Failed to place order: " << e.what());
-  }
-  return false;
+        // A 401 retry is signed and sent again, so the stages describe the
+        // last attempt and signed_to_sent includes the token refresh.
+        if (resp.sent_ns != 0) {
+          int64_t parsed_ns = monoNowNs();
+          OrderLatency& latency = orderLatency();
+          latency.signed_to_sent.record(resp.sent_ns - signed_ns);
+          latency.sent_to_response.record(resp.received_ns - resp.sent_ns);
+          latency.response_to_parsed.record(parsed_ns - resp.received_ns);
+          if (trace.tick_ns != 0) {
+            latency.tick_to_wire.record(resp.sent_ns - trace.tick_ns);
+            if (ok) latency.tick_to_ack.record(parsed_ns - trace.tick_ns);
+          }
+        }
+        done(ok);
+      },
+      &request_id);
+}
+
+std::future<bool> StandXClient::submitOrder(Order& order, bool tp) {
+  auto promise = std::make_shared<std::promise<bool>>();
+  std::future<bool> future = promise->get_future();
+  submitOrder(order, tp, [promise](bool ok) { promise->set_value(ok); });
+  return future;
+}
+
+std::future<bool> StandXClient::placeOrderAsync(Order& order) {
+  return submitOrder(order, false);
+}
+
+std::future<bool> StandXClient::tpOrderAsync(Order& order) {
+  return submitOrder(order, true);
 }
 
-bool StandXClient::tpOrder(Order& order) {
-  if (access_token_.empty()) {
+std::future<AmendStatus> StandXClient::amendOrderAsync(int64_t id,
+                                                       Order& order,
+                                                       bool tp) {
+  if (get_access_token().empty()) {
     throw std::runtime_error("not logged in, call login() first");
   }
 
-  nlohmann::json order_json;
-  order_json["symbol"] = symbol_;
+  auto promise = std::make_shared<std::promise<AmendStatus>>();
+  std::future<AmendStatus> future = promise->get_future();
 
-  std::string side = order.side;
-  std::transform(side.begin(), side.end(), side.begin(), ::tolower);
-  order_json["side"] = side;
+  if (id <= 0) {
+    ERROR("Order id is required for amend");
+    promise->set_value(AmendStatus::kRejected);
+    return future;
+  }
 
-  std::string type = order.type;
-  std::transform(type.begin(), type.end(), type.begin(), ::tolower);
-  order_json["order_type"] = type;
-  order_json["qty"] = std::to_string(order.size);
+  // StandX has no modify endpoint, so an amend is a cancel-replace done on
+  // the event loop: the replacement is queued for signing from the cancel's
+  // completion, and only if the venue acknowledged the cancel. The old and
+  // new orders are never live together, and a refused cancel (the order
+  // just filled) leaves nothing to undo.
+  nlohmann::json cancel_req;
+  cancel_req["order_id"] = id;
+  std::string url = api_base_url_ + "/api/cancel_order";
+  submitSigned(
+      url, cancel_req.dump(),
+      [this, promise, id, tp, &order,
+       trace = currentTickTrace()](HttpResponse& resp) {
+        std::string why;
+        if (!acknowledged(resp, why)) {
+          ERROR("Amend cancel refused for order " << id << ": " << why);
+          promise->set_value(AmendStatus::kRejected);
+          return;
+        }
+        try {
+          // The replacement goes to the signer, off the strategy thread.
+          ScopedTickTrace scoped(trace);
+          submitOrder(order, tp, [promise, id](bool ok) {
+            if (!ok) ERROR("Amend replace failed for order " << id);
+            promise->set_value(ok ? AmendStatus::kAmended
+                                  : AmendStatus::kReplaceFailed);
+          });
+        } catch (const std::exception& e) {
+          ERROR("Amend replace failed for order " << id << ": " << e.what());
+          promise->set_value(AmendStatus::kReplaceFailed);
+        }
+      });
+  return future;
+}
 
-  order_json["time_in_force"] = "alo";
-  order_json["reduce_only"] = true;
-  order_json["price"] = safeFtos(order.tp_price, PRICE_ACCURACY_INT);
+void StandXClient::sleep(int ms) { SLEEP_MS(ms); }
 
-  std::string url = api_base_url_ + "/api/new_order";
-  std::string body = order_json.dump();
-
-  std::random_device rd;
-  std::mt19937_64 gen(rd());
-  std::uniform_int_distribution<uint64_t> dis;
-
-  std::stringstream ss;
-  ss << std::hex << std::setfill('0') << std::setw(8) << (dis(gen) & 0xFFFFFFFF)
-     << "-" << std::setw(4) << (dis(gen) & 0xFFFF) << "-" << std::setw(4)
-     << ((dis(gen) & 0x0FFF) | 0x4000) << "-" << std::setw(4)
-     << ((dis(gen) & 0x3FFF) | 0x8000) << "-" << std::setw(12)
-     << (dis(gen) & 0xFFFFFFFFFFFF);
-  std::string request_id = ss.str();
-
-  auto now = std::chrono::system_clock::now();
-  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                now.time_since_epoch())
-                .count();
-  std::string timestamp = std::to_string(ms);
-
-  std::string version = "v1";
-  std::string message =
-      version + "," + request_id + "," + timestamp + "," + body;
-
-  std::string signature = auth_->sign_ed25519_base64(message);
-  std::map<std::string, std::string> extra_headers;
-  extra_headers["x-request-sign-version"] = version;
-  extra_headers["x-request-id"] = request_id;
-  extra_headers["x-request-timestamp"] = timestamp;
-  extra_headers["x-request-signature"] = signature;
+AmendStatus StandXClient::amendOrder(int64_t id, Order& order, bool tp) {
+  return amendOrderAsync(id, order, tp).get();
+}
 
-  try {
-    std::string response =
-        http_->post_json_with_auth(url, body, access_token_, extra_headers);
-
-    auto json_response = nlohmann::json::parse(response);
-        if (json_response.contains("message") &&
-            json_response["message"].is_string()) {
-          std::string msg = json_response["message"].get<std::string>();
-          if (msg == "success") {
-            DEBUG("TP order placed ok: " << order.id);
-            return true;
-          } else {
-            DEBUG("TP placement returned message: " << msg);
-          }
-        }
-  } catch (const std::exception& e) {
-    ERROR("Failed to place TP order: " << e.what());
-  }
-  return false;
+bool StandXClient::placeOrder(Order& order) {
+  return placeOrderAsync(order).get();
 }
 
-void StandXClient::cancelOrder(const std::string& id) {
-  if (access_token_.empty()) {
+bool StandXClient::tpOrder(Order& order) { return tpOrderAsync(order).get(); }
+
+std::future<bool> StandXClient::cancelOrderAsync(int64_t id) {
+  if (get_access_token().empty()) {
     throw std::runtime_error("not logged in, call login() first");
   }
 
-  if (id.empty()) {
+  auto promise = std::make_shared<std::promise<bool>>();
+  std::future<bool> future = promise->get_future();
+
+  if (id <= 0) {
     ERROR("Order id is required for cancel");
-    return;
+    promise->set_value(false);
+    return future;
   }
 
   nlohmann::json cancel_req;
-  try {
-    long long oid = std::stoll(id);
-    cancel_req["order_id"] = oid;
-  } catch (const std::exception& e) {
-    ERROR("Invalid order id for cancel: " << id << ": " << e.what());
-    return;
-  }
+  cancel_req["order_id"] = id;
 
   std::string url = api_base_url_ + "/api/cancel_order";
-  std::string body = cancel_req.dump();
-
-  std::random_device rd;
-  std::mt19937_64 gen(rd());
-  std::uniform_int_distribution<uint64_t> dis;
-
-  std::stringstream ss;
-  ss << std::hex << std::setfill('0') << std::setw(8) << (dis(gen) & 0xFFFFFFFF)
-     << "-" << std::setw(4) << (dis(gen) & 0xFFFF) << "-" << std::setw(4)
-     << ((dis(gen) & 0x0FFF) | 0x4000) << "-" << std::setw(4)
-     << ((dis(gen) & 0x3FFF) | 0x8000) << "-" << std::setw(12)
-     << (dis(gen) & 0xFFFFFFFFFFFF);
-  std::string request_id = ss.str();
-
-  auto now = std::chrono::system_clock::now();
-  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                now.time_since_epoch())
-                .count();
-  std::string timestamp = std::to_string(ms);
-
-  std::string version = "v1";
-  std::string message =
-      version + "," + request_id + "," + timestamp + "," + body;
-
-  std::string signature = auth_->sign_ed25519_base64(message);
-
-  std::map<std::string, std::string> extra_headers;
-  extra_headers["x-request-sign-version"] = version;
-  extra_headers["x-request-id"] = request_id;
-  extra_headers["x-request-timestamp"] = timestamp;
-  extra_headers["x-request-signature"] = signature;
+  submitSigned(url, cancel_req.dump(), [promise, id](HttpResponse& resp) {
+    std::string why;
+    bool ok = acknowledged(resp, why);
+    if (!ok) ERROR("Failed to cancel order " << id << ": " << why);
+    promise->set_value(ok);
+  });
+  return future;
+}
 
-  try {
-    http_->post_json_with_auth(url, body, access_token_, extra_headers);
-  } catch (const std::exception& e) {
-    ERROR("Failed to cancel order " << id << ": " << e.what());
+void StandXClient::cancelOrder(int64_t id) {
+  cancelOrderAsync(id).get();
+}
+
+std::vector<bool> StandXClient::placeOrders(std::vector<Order>& orders) {
+  // new_order takes a single order, so a batch is pipelined: every request
+  // is queued before the first response is awaited, and the signer signs
+  // one while the one before it is on the wire.
+  std::vector<std::future<bool>> futures;
+  futures.reserve(orders.size());
+  for (auto& order : orders) {
+    futures.push_back(placeOrderAsync(order));
   }
+
+  std::vector<bool> results;
+  results.reserve(orders.size());
+  for (auto& f : futures) {
+    results.push_back(f.get());
+  }
+  return results;
+}
+
+std::vector<bool> StandXClient::cancelOrders(const std::vector<int64_t>& ids,
+                                             std::vector<int64_t>* filled) {
+  if (get_access_token().empty()) {
+    throw std::runtime_error("not logged in, call login() first");
+  }
+
+  std::vector<bool> results(ids.size(), false);
+  std::vector<int64_t> oids;
+  std::vector<size_t> index;
+  for (size_t i = 0; i < ids.size(); ++i) {
+    if (ids[i] <= 0) {
+      ERROR("Invalid order id for cancel: " << ids[i]);
+      continue;
+    }
+    oids.push_back(ids[i]);
+    index.push_back(i);
+  }
+
+  std::string url = api_base_url_ + "/api/cancel_orders";
+  std::vector<std::future<HttpResponse>> futures;
+  std::vector<std::pair<size_t, size_t>> chunks;
+  for (size_t begin = 0; begin < oids.size(); begin += MAX_BATCH_CANCEL) {
+    size_t end = std::min(oids.size(), begin + MAX_BATCH_CANCEL);
+    nlohmann::json cancel_req;
+    cancel_req["order_id_list"] =
+        std::vector<int64_t>(oids.begin() + begin, oids.begin() + end);
+    auto promise = std::make_shared<std::promise<HttpResponse>>();
+    futures.push_back(promise->get_future());
+    submitSigned(url, cancel_req.dump(), [promise](HttpResponse& resp) {
+      promise->set_value(std::move(resp));
+    });
+    chunks.emplace_back(begin, end);
+  }
+
+  std::vector<std::future<bool>> fallback;
+  std::vector<size_t> fallback_index;
+  std::vector<size_t> unconfirmed;
+  for (size_t c = 0; c < chunks.size(); ++c) {
+    HttpResponse resp = futures[c].get();
+    std::string why;
+    if (acknowledged(resp, why)) {
+      for (size_t k = chunks[c].first; k < chunks[c].second; ++k) {
+        unconfirmed.push_back(index[k]);
+      }
+      continue;
+    }
+
+    ERROR("Batch cancel failed: " << why << ", body: " << resp.body);
+    // Fall back to single cancels, still all in flight at once.
+    for (size_t k = chunks[c].first; k < chunks[c].second; ++k) {
+      fallback.push_back(cancelOrderAsync(ids[index[k]]));
+      fallback_index.push_back(index[k]);
+    }
+  }
+
+  // The batch reply has no per-id results. An id still open was not
+  // cancelled; one that is gone was either cancelled or filled first, which
+  // only its own status tells apart. If a poll fails the id stays false and
+  // the caller tries again.
+  std::vector<Order> gone;
+  std::vector<size_t> gone_index;
+  if (!unconfirmed.empty()) {
+    std::vector<Order> open_orders;
+    if (unfilledOrders(open_orders)) {
+      std::vector<int64_t> open_ids;
+      open_ids.reserve(open_orders.size());
+      for (const auto& order : open_orders) open_ids.push_back(order.id);
+      std::sort(open_ids.begin(), open_ids.end());
+      for (size_t i : unconfirmed) {
+        if (std::binary_search(open_ids.begin(), open_ids.end(), ids[i])) {
+          ERROR("Order " << ids[i] << " still open after batch cancel");
+          continue;
+        }
+        gone.emplace_back();
+        gone.back().id = ids[i];
+        gone_index.push_back(i);
+      }
+    } else {
+      ERROR("Could not confirm batch cancel of " << unconfirmed.size()
+                                                 << " orders");
+    }
+  }
+
+  // Every status query is in flight at once. They write into gone, which
+  // is not resized again.
+  std::vector<std::future<bool>> details;
+  details.reserve(gone.size());
+  for (auto& order : gone) details.push_back(detailAsync(order));
+  for (size_t k = 0; k < gone.size(); ++k) {
+    if (!details[k].get()) {
+      ERROR("Could not confirm cancel of order " << gone[k].id);
+      continue;
+    }
+    results[gone_index[k]] = gone[k].status == OrderStatus::kCanceled;
+    if (gone[k].status == OrderStatus::kFilled && filled != nullptr) {
+      filled->push_back(gone[k].id);
+    }
+  }
+
+  for (size_t i = 0; i < fallback.size(); ++i) {
+    results[fallback_index[i]] = fallback[i].get();
+  }
+  return results;
+}
+
+bool StandXClient::cancelAllOrders() {
+  std::vector<Order> open_orders;
+  if (!unfilledOrders(open_orders)) {
+    return false;
+  }
+
+  std::vector<int64_t> ids;
+  for (const auto& order : open_orders) {
+    if (order.id != 0) ids.push_back(order.id);
+  }
+  if (ids.empty()) {
+    return true;
+  }
+
+  auto results = cancelOrders(ids);
+  bool ok = std::all_of(results.begin(), results.end(),
+                        [](bool r) { return r; });
+  NOTICE("Cancel all orders " << symbol_ << ": " << ids.size()
+                              << (ok ? " ok" : " with failures"));
+  return ok;
 }
 
 }  // namespace standx
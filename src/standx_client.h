@@ -1,57 +1,148 @@
 #pragma once
 
-#include <list>
+#include <functional>
+#include <future>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "async_http_client.h"
 #include "data.h"
+#include "exchange.h"
+#include "latency.h"
+#include "session.h"
 
 namespace standx {
 
-class HttpClient;
 class AuthManager;
 
-class StandXClient {
+// Conversions between StandX wire strings and the compact Order fields.
+// Everything outside the API boundary works on the enums and raw ids.
+
+// "open", "filled", ... to NEW / FILLED / CANCELED / FAILED / UNKNOWN.
+OrderStatus mapOrderStatus(std::string_view api_status);
+
+// "buy" / "BUY" / "sell" / "SELL".
+OrderSide parseOrderSide(std::string_view side);
+
+// Canonical 8-4-4-4-12 lowercase UUID text.
+std::string formatClientOrderId(const ClientOrderId& id);
+
+// False (and out left empty) unless text is a 36-character UUID.
+bool parseClientOrderId(std::string_view text, ClientOrderId& out);
+
+class StandXClient : public Exchange {
  public:
+  // Logs in on a session of its own.
   StandXClient(const std::string& chain, const std::string& private_key_hex,
                const std::string& symbol);
-  ~StandXClient();
+
+  // Trades symbol on an already logged-in session shared with other
+  // clients. Requests still in flight reference this client, so keep it
+  // alive as long as the session.
+  StandXClient(std::shared_ptr<Session> session, const std::string& symbol);
+  ~StandXClient() override;
 
   std::string get_address() const;
 
-  std::string getInstId() const { return symbol_; }
+  std::string getInstId() const override { return symbol_; }
 
   std::string login();
 
-  bool positions(std::vector<Position>& positions_list);
+  bool positions(std::vector<Position>& positions_list) override;
+
+  bool detail(Order& order) override;
+
+  // Look an order up by order.clientId; fills order.id and order.status.
+  bool detailByClientId(Order& order) override;
+
+  // Non-blocking variants: the request goes out on the async engine and the
+  // future resolves when the response is parsed. The order must stay alive
+  // until then.
+  std::future<bool> detailAsync(Order& order);
+  std::future<bool> detailByClientIdAsync(Order& order) override;
+
+  std::future<bool> placeOrderAsync(Order& order) override;
 
-  bool detail(Order& order);
+  std::future<bool> tpOrderAsync(Order& order) override;
 
-  bool unfilledOrders(std::list<Order>& order_list);
+  std::future<bool> cancelOrderAsync(int64_t id);
 
-  bool tickers(Ticker& tk);
+  // Move live order id to order's price / size (tp_price for a TP). On
+  // kAmended order carries the new ids, as after placeOrder / tpOrder.
+  std::future<AmendStatus> amendOrderAsync(int64_t id, Order& order,
+                                           bool tp) override;
 
-  bool placeOrder(Order& order);
+  // order_list is cleared and refilled; pass a reused vector to keep its
+  // capacity.
+  bool unfilledOrders(std::vector<Order>& order_list) override;
+
+  bool tickers(Ticker& tk) override;
+
+  bool placeOrder(Order& order) override;
 
   bool tpOrder(Order& order);
 
-  void cancelOrder(const std::string& id);
+  void cancelOrder(int64_t id);
+
+  AmendStatus amendOrder(int64_t id, Order& order, bool tp);
+
+  // Place many orders in one go; results[i] tells whether orders[i] was
+  // accepted. Orders are pipelined since new_order takes one order per call.
+  std::vector<bool> placeOrders(std::vector<Order>& orders);
+
+  // Cancel many orders with as few signed cancel_orders calls as possible;
+  // results[i] is for ids[i]. cancel_orders answers one message for the
+  // whole list and skips ids that are not open, so an acknowledged batch is
+  // confirmed against unfilledOrders, and each id no longer open is queried:
+  // results[i] is true only if ids[i] is cancelled, and ids that filled
+  // first go to filled.
+  std::vector<bool> cancelOrders(
+      const std::vector<int64_t>& ids,
+      std::vector<int64_t>* filled = nullptr) override;
 
-  std::string get_access_token() const { return access_token_; }
+  // Cancel every open order of this client's symbol.
+  bool cancelAllOrders();
 
-  AuthManager* get_auth_manager() const { return auth_.get(); }
+  std::string get_access_token() const;
 
-  bool balance(float& availBal, float& totalBal);
+  AuthManager* get_auth_manager() const;
+
+  std::shared_ptr<Session> session() const { return session_; }
+
+  bool balance(float& availBal, float& totalBal) override;
+
+  void sleep(int ms) override;
 
  private:
   std::string request_with_retry(const std::string& url);
-
-  std::unique_ptr<HttpClient> http_;
-  std::unique_ptr<AuthManager> auth_;
-  std::string chain_;
+  static ClientOrderId newClientOrderId();
+  // Signs body on the session's signer, then POSTs it to url; a signing
+  // failure reaches callback as a response with error set.
+  void submitSigned(const std::string& url, std::string body,
+                    AsyncHttpClient::Callback callback);
+  std::string orderBody(const Order& order, bool tp) const;
+  std::future<bool> submitOrder(Order& order, bool tp);
+  void submitOrder(Order& order, bool tp, std::function<void(bool)> done);
+  void submitOrderSigned(const std::string& url, const std::string& body,
+                         const std::vector<std::string>& headers,
+                         const ClientOrderId& request_id, const char* what,
+                         Order& order, int64_t signed_ns, TickTrace trace,
+                         std::function<void(bool)> done);
+  // Adds the bearer token and sends. A 401 is retried once: the token is
+  // refreshed on the signer thread, off the event loop, and a request
+  // signed under request_id is signed again there, as its signature
+  // covers the request id and timestamp along with the body.
+  void submitWithAuth(const std::string& method, const std::string& url,
+                      const std::string& body,
+                      const std::vector<std::string>& headers,
+                      AsyncHttpClient::Callback callback,
+                      const ClientOrderId* request_id = nullptr,
+                      bool retry_on_401 = true);
+
+  std::shared_ptr<Session> session_;
   std::string symbol_;
-  std::string access_token_;
   std::string api_base_url_;
 };
 
@@ -1,5 +1,6 @@
 #include "strategy.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <cstring>
@@ -7,7 +8,6 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
-#include <numeric>
 #include <sstream>
 #include <string>
 
@@ -15,14 +15,44 @@
 #include "Poco/DateTimeFormatter.h"
 #include "Poco/Timestamp.h"
 #include "Poco/Timezone.h"
+#include "journal.h"
+#include "latency.h"
 #include "tracer.h"
 #include "util.h"
 
-using standx::StandXClient;
-static int s_win_cnt = 0;
-static int s_lose_cnt = 0;
-static float s_pnl = 0.0;
-Strategy::Strategy(std::shared_ptr<StandXClient> client) : client_(client) {
+using standx::Journal;
+using standx::JournalEvent;
+
+namespace {
+
+// How long a placement may take to show up on the order stream before it is
+// looked up over REST instead.
+const auto kStreamResolveTimeout = std::chrono::milliseconds(500);
+
+// The take-profit leg of a grid level as an order of its own.
+Order TpLeg(const Order& level) {
+  Order tp = level;
+  tp.id = level.tpId;
+  tp.clientId = level.tpClientId;
+  tp.price = level.tp_price;
+  tp.side = level.positionSide == PositionSide::kLong ? OrderSide::kSell
+                                                      : OrderSide::kBuy;
+  tp.is_reduce_only = true;
+  return tp;
+}
+
+}  // namespace
+
+Strategy::Strategy(std::shared_ptr<standx::Exchange> client,
+                   std::unique_ptr<standx::WaitStrategy> wait_strategy,
+                   std::optional<GridParams> params)
+    : client_(client),
+      events_(std::make_unique<standx::EventQueue>(
+          wait_strategy ? std::move(wait_strategy)
+                        : standx::WaitStrategy::create(
+                              kConfig.strategyWaitStrategy))) {
+  instId_ = client_->getInstId();
+  params_ = params ? *params : DefaultParams(instId_);
   Init();
 }
 
@@ -39,16 +69,43 @@ void Strategy::start() {
 
 void Strategy::stop() {
   thread_running_ = false;
+  events_->post(standx::kEventShutdown);
   if (thread_ != nullptr) {
     thread_->join();
     thread_ = nullptr;
   }
 }
 
+void Strategy::SetMarketDataFeed(std::shared_ptr<MarketDataFeed> feed) {
+  feed_ = feed;
+  feed_->add_listener([this](const std::string& symbol, double last) {
+    if (symbol == instId_) OnPrice(last);
+  });
+}
+
+void Strategy::SetOrderEventStream(std::shared_ptr<OrderEventStream> stream) {
+  order_stream_ = stream;
+  order_stream_->add_listener([this](const standx::OrderState& state) {
+    if (state.symbol.empty() || state.symbol == instId_) {
+      events_->post(standx::kEventOrderUpdate);
+    }
+  });
+}
+
+void Strategy::OnPrice(double last) {
+  // Only a move across a grid level can change the desired orders; ticks
+  // inside the same level are left to the timer.
+  if (order_interval_ <= 0) return;
+  int64_t level = static_cast<int64_t>(std::floor(last / order_interval_));
+  if (price_level_.exchange(level, std::memory_order_relaxed) != level) {
+    events_->post(standx::kEventPriceChanged);
+  }
+}
+
 void Strategy::Init() {
   UpdatePosition();
-  UpdatePrice();
   InitParameters();
+  UpdatePrice();
   CheckUnfilledOrders();
   if (grid_long_) {
     InitLongPlaceOrders();
@@ -60,32 +117,35 @@ void Strategy::Init() {
   }
 }
 
-void Strategy::InitParameters() {
-  instId_ = client_->getInstId();
-  order_price_round_ = safeFtos(PRICE_ACCURACY_FLOAT, PRICE_ACCURACY_INT);
+GridParams Strategy::DefaultParams(const std::string& inst_id) {
+  GridParams params;
+  if (inst_id == "BTC-USD") {
+    params.grid_size = kConfig.subBtcSize;
+    params.base_price = 100000;
+    params.order_interval = 100;
+  } else if (inst_id == "ETH-USD") {
+    params.grid_size = kConfig.subEthSize;
+    params.base_price = 4000;
+    params.order_interval = 5;
+  } else if (inst_id == "SOL-USD") {
+    params.grid_size = kConfig.subSolSize;
+    params.base_price = 200;
+    params.order_interval = 0.25;
+  }
+  return params;
+}
 
+void Strategy::InitParameters() {
   grid_long_ = kConfig.gridLong;
   grid_short_ = kConfig.gridShort;
-  base_price_ = current_price_;
-  grid_size_ = DEFAULT_CONTRACT_SIZE;
-  order_interval_ = 0.1;
+  grid_size_ = params_.grid_size;
+  order_interval_ = params_.order_interval;
+  base_price_ = params_.base_price;
 
   Poco::DateTime now;
   last_reset_success_trades_day_ = now.day();
 
-  if (instId_ == "BTC-USD") {
-    grid_size_ = kConfig.subBtcSize;
-    base_price_ = 100000;
-    order_interval_ = 100;
-  } else if (instId_ == "ETH-USD") {
-    grid_size_ = kConfig.subEthSize;
-    base_price_ = 4000;
-    order_interval_ = 5;
-  } else if (instId_ == "SOL-USD") {
-    grid_size_ = kConfig.subSolSize;
-    base_price_ = 200;
-    order_interval_ = 0.25;
-  }
+  open_orders_.set_tick_size(order_interval_);
 }
 
 bool Strategy::UpdatePosition() {
@@ -98,689 +158,988 @@ bool Strategy::UpdatePosition() {
   for (auto& pos : positions_list) {
     DEBUG("Update Postion mode: " << pos.positionSide
                                   << ", size: " << pos.positionAmt);
-    if (pos.positionSide == "LONG") {
-      long_pos_ = pos;
-    } else if (pos.positionSide == "SHORT") {
-      short_pos_ = pos;
+    Position* held = pos.positionSide == PositionSide::kLong    ? &long_pos_
+                     : pos.positionSide == PositionSide::kShort ? &short_pos_
+                                                                : nullptr;
+    if (held == nullptr) continue;
+    if (held->positionAmt != pos.positionAmt) {
+      Journal::instance().position(instId_, pos);
     }
+    *held = pos;
   }
   return true;
 }
 
 void Strategy::UpdatePrice() {
-  Ticker tk;
-  if (client_->tickers(tk)) {
-    current_price_ = tk.last;
-    int price_int = current_price_ / order_interval_;
-    current_fix_long_price_ = price_int * order_interval_;
-    current_fix_short_price_ = current_fix_long_price_ + order_interval_;
-    INFO("Current price: " << instId_ << " " << current_price_ << " "
-                           << current_fix_long_price_ << " "
-                           << current_fix_short_price_);
+  // Prefer the streamed snapshot; poll the REST ticker only when the feed is
+  // down or has gone quiet.
+  standx::Quote quote;
+  if (feed_ && feed_->latest(instId_, quote) && quote.last > 0 &&
+      quote.age_ms() < MAX_QUOTE_AGE_MS) {
+    current_price_ = quote.last;
+    price_ns_ = quote.recv_us * 1000;
   } else {
-    ERROR("Failed to get current price");
+    Ticker tk;
+    if (!client_->tickers(tk)) {
+      ERROR("Failed to get current price");
+      return;
+    }
+    current_price_ = tk.last;
+    price_ns_ = standx::monoNowNs();
+  }
+
+  if (current_price_ != journal_price_) {
+    journal_price_ = current_price_;
+    Journal::instance().price(instId_, current_price_);
   }
+
+  current_fix_long_tick_ =
+      static_cast<int64_t>(current_price_ / order_interval_);
+  current_fix_long_price_ = TickPrice(current_fix_long_tick_);
+  current_fix_short_price_ = TickPrice(current_fix_long_tick_ + 1);
+  auto keep = [this](int64_t tick, const Order& level) {
+    if (level.status == OrderStatus::kIdle) return false;
+    WARNING("Grid level left the window with status " << level.status
+            << ", tick: " << tick << ", id: " << level.id
+            << ", tp id: " << level.tpId);
+    return true;
+  };
+  long_grid_ladder_.recenter(current_fix_long_tick_, keep);
+  short_grid_ladder_.recenter(current_fix_long_tick_, keep);
+  INFO("Current price: " << instId_ << " " << current_price_ << " "
+                         << current_fix_long_price_ << " "
+                         << current_fix_short_price_);
 }
 
 void Strategy::RunGrid() {
   if (!CheckUnfilledOrders()) {
     return;
   }
+  // One tick plans one desired order set, diffs it against the book and
+  // dispatches the result in a single batch.
+  reconciler_.reset();
   if (grid_long_) {
     RunLongGrid();
   }
   if (grid_short_) {
     RunShortGrid();
   }
+  standx::GridActions actions = reconciler_.diff(open_orders_);
+  if (actions.empty()) return;
+
+  // Orders sent below carry the price time and this decision time, so the
+  // client can attribute every stage up to the exchange's answer.
+  static standx::LatencyHistogram& tick_to_decision =
+      standx::LatencyRegistry::instance().get("order tick_to_decision");
+  standx::TickTrace trace{price_ns_, standx::monoNowNs()};
+  if (trace.tick_ns != 0) {
+    tick_to_decision.record(trace.decision_ns - trace.tick_ns);
+  }
+  standx::ScopedTickTrace scoped(trace);
+  DispatchGridActions(actions);
+}
+
+void Strategy::Step() {
+  ResetDailyCounters();
+  UpdatePrice();
+  UpdatePosition();
+  RunGrid();
 }
 
 void Strategy::run() {
-  INFO("Strategy start running " << instId_);
+  INFO("Strategy start running " << instId_ << ", wait strategy "
+                                  << events_->wait_strategy());
+  if (kConfig.strategyCpu >= 0 &&
+      !standx::pinCurrentThread(kConfig.strategyCpu)) {
+    WARNING("Failed to pin strategy thread to cpu " << kConfig.strategyCpu);
+  }
+
+  auto tick = std::chrono::milliseconds(kConfig.strategyTickIntervalMs);
   while (thread_running_) {
-    ResetDailyCounters();
-    UpdatePrice();
-    UpdatePosition();
-    RunGrid();
+    Step();
+
+    // Sleep until the price crosses a level, an order changes state, the
+    // tick interval passes or stop() is called.
+    uint32_t events = events_->wait(tick);
+    if (events & standx::kEventShutdown) break;
+    DEBUG("Strategy wake up, events " << events);
   }
   INFO("Strategy stop running " << instId_);
 }
 
+bool Strategy::QueryOrderStatus(Order& order) {
+  // A placement that could not be resolved when it was applied is still
+  // known only by its client order id.
+  if (order.id == 0 && !order.clientId.empty()) {
+    Order resolved;
+    if (!LookupClientOrder(order.clientId, resolved)) return false;
+    order.id = resolved.id;
+    order.status = resolved.status;
+    return true;
+  }
+
+  // Once the private stream is up and authenticated, the local table is
+  // authoritative for every order it has seen; REST is only hit once per
+  // order to seed it. Until then every open order is polled over REST.
+  bool streaming = order_stream_ && order_stream_->is_connected();
+  if (streaming && order.id != 0) {
+    standx::OrderState state;
+    if (order_stream_->table().find(order.id, state)) {
+      order.status = state.status;
+      return true;
+    }
+  }
+
+  if (!client_->detail(order)) {
+    return false;
+  }
+  if (streaming) {
+    SeedOrderState(order.id, order.status);
+  }
+  return true;
+}
+
+void Strategy::SeedOrderState(int64_t id, OrderStatus status) {
+  if (!order_stream_ || id == 0) return;
+  standx::OrderState state;
+  state.id = id;
+  state.symbol = instId_;
+  state.status = status;
+  order_stream_->table().seed(state);
+}
+
 bool Strategy::CheckUnfilledOrders() {
-  unfilled_orders_.clear();
-  if (!client_->unfilledOrders(unfilled_orders_)) {
+  if (!client_->unfilledOrders(open_orders_snapshot_)) {
     ERROR("Failed to get unfilled orders");
     return false;
   }
 
+  open_orders_.sync(open_orders_snapshot_);
   return true;
 }
 
 void Strategy::CheckFilledLongOrders() {
   // pending buy orders FILLED check
-  for (auto it = long_grid_order_list_.rbegin();
-       it != long_grid_order_list_.rend(); ++it) {
-    Order& order = it->second;
-    if (order.status != "NEW" && order.status != "PARTIALLY_FILLED" &&
-        order.status != "FILLED_OPEN_IMMEDIATE") {
-      continue;
-    }
+  for (int64_t tick = long_grid_ladder_.last_tick();
+       tick >= long_grid_ladder_.first_tick(); --tick) {
+    if (!CheckLongPlaceFill(tick)) break;
+  }
+
+  // pending tp orders FILLED check
+  for (int64_t tick = long_grid_ladder_.first_tick();
+       tick <= long_grid_ladder_.last_tick(); ++tick) {
+    if (!CheckLongTpFill(tick)) break;
+  }
 
-    bool tp = false;
-    if (order.status == "FILLED_OPEN_IMMEDIATE") {
+  // Levels the price has run away from are checked one by one.
+  const auto& overflow = long_grid_ladder_.overflow();
+  for (auto it = overflow.begin(); it != overflow.end();) {
+    int64_t tick = (it++)->first;
+    CheckLongPlaceFill(tick);
+    CheckLongTpFill(tick);
+  }
+}
+
+void Strategy::CheckFilledShortOrders() {
+  for (int64_t tick = short_grid_ladder_.first_tick();
+       tick <= short_grid_ladder_.last_tick(); ++tick) {
+    if (!CheckShortPlaceFill(tick)) break;
+  }
+
+  for (int64_t tick = short_grid_ladder_.last_tick();
+       tick >= short_grid_ladder_.first_tick(); --tick) {
+    if (!CheckShortTpFill(tick)) break;
+  }
+
+  const auto& overflow = short_grid_ladder_.overflow();
+  for (auto it = overflow.begin(); it != overflow.end();) {
+    int64_t tick = (it++)->first;
+    CheckShortPlaceFill(tick);
+    CheckShortTpFill(tick);
+  }
+}
+
+// Checks the opening order of the long level at tick and wants a TP once
+// it has filled. Returns false when the levels further from the price
+// need not be checked this pass.
+bool Strategy::CheckLongPlaceFill(int64_t tick) {
+  Order* level = long_grid_ladder_.find(tick);
+  if (level == nullptr) return true;
+  Order& order = *level;
+  if (order.status != OrderStatus::kNew &&
+      order.status != OrderStatus::kPartiallyFilled &&
+      order.status != OrderStatus::kFilledOpenImmediate) {
+    return true;
+  }
+
+  bool tp = false;
+  if (order.status == OrderStatus::kFilledOpenImmediate) {
+    tp = true;
+  } else if (QueryOrderStatus(order)) {
+    INFO("Check Filled place order: " << order.price
+                                      << ", key: " << TickPrice(tick)
+                                      << ", order.id: " << order.id
+                                      << ", status: " << order.status);
+    if (order.status == OrderStatus::kFilled) {
       tp = true;
-    } else if (client_->detail(order)) {
-      INFO("Check Filled place order: " << order.price << ", key: " << it->first
-                                        << ", order.id: " << order.id
-                                        << ", status: " << order.status);
-      if (order.status == "FILLED") {
-        tp = true;
-        NOTICE("TRADE long place order FILLED: " << it->first
-                                                 << ", price: " << order.price);
-      } else if (order.status == "FAILED") {
-        ERROR("place order failed: " << it->first);
-        auto it_to_erase = std::prev(it.base());
-        long_grid_order_list_.erase(it_to_erase);
-        break;
-      } else if (order.status == "NEW") {
-        DEBUG("place order still NEW: " << it->first);
-        break;
-      } else if (order.status == "PARTIALLY_FILLED") {
-        DEBUG("place order PARTIALLY_FILLED: " << it->first);
-        break;
-      } else if (order.status == "CANCELED") {
-        DEBUG("place order CANCELED: " << it->first);
-        order.status = "IDLE";
-        break;
-      } else {
-        ERROR("place order failed: " << it->first << ", id: " << order.id
-                                     << ", status: " << order.status);
-        break;
-      }
+      NOTICE("TRADE long place order FILLED: " << TickPrice(tick)
+                                               << ", price: " << order.price);
+      Journal::instance().order(JournalEvent::kFill, instId_, order);
+    } else if (order.status == OrderStatus::kFailed) {
+      ERROR("place order failed: " << TickPrice(tick));
+      long_grid_ladder_.erase(tick);
+      return false;
+    } else if (order.status == OrderStatus::kNew) {
+      DEBUG("place order still NEW: " << TickPrice(tick));
+      return false;
+    } else if (order.status == OrderStatus::kPartiallyFilled) {
+      DEBUG("place order PARTIALLY_FILLED: " << TickPrice(tick));
+      return false;
+    } else if (order.status == OrderStatus::kCanceled) {
+      DEBUG("place order CANCELED: " << TickPrice(tick));
+      order.status = OrderStatus::kIdle;
+      return false;
+    } else {
+      ERROR("place order failed: " << TickPrice(tick) << ", id: " << order.id
+                                   << ", status: " << order.status);
+      return false;
     }
+  }
 
-    if (tp) {
-      int try_count = 10;
-      for (int i = 0; i < try_count; ++i) {
-        float tp_price =
-            std::max(current_fix_long_price_, order.price) + order_interval_;
-        order.size = grid_size_;
-        order.tp_price = tp_price;
-        order.side = "SELL";
-        order.positionSide = "LONG";
-        order.type = "LIMIT";
-        DEBUG("TRADE Calculated tp_price: "
-              << tp_price << ", current_fix_long_price_: "
-              << current_fix_long_price_ << ", order.price: " << order.price
-              << ", order_interval_: " << order_interval_);
-
-        if (!client_->tpOrder(order)) {
-          UpdatePrice();
-        } else {
-          SyncTpOrderId(order);
-          DEBUG("TRADE Place TP order ok for "
-                << it->first << " " << order.price << " " << order_interval_
-                << " " << current_fix_long_price_ << ", tp_price: " << tp_price
-                << ", tp id: " << order.tpId);
-          break;
-        }
-      }
-    }
+  if (tp) {
+    float tp_price =
+        std::max<float>(current_fix_long_price_, order.price) +
+        order_interval_;
+    DEBUG("TRADE Calculated tp_price: "
+          << tp_price << ", current_fix_long_price_: "
+          << current_fix_long_price_ << ", order.price: " << order.price
+          << ", order_interval_: " << order_interval_);
+    // Stays FILLED_OPEN_IMMEDIATE until a TP is resting, so a failed
+    // placement is retried on the next tick.
+    order.status = OrderStatus::kFilledOpenImmediate;
+    WantTakeProfit(tick, order, PositionSide::kLong, tp_price, 0);
   }
+  return true;
+}
 
-  // pending tp orders FILLED check
-  for (auto it = long_grid_order_list_.begin();
-       it != long_grid_order_list_.end(); ++it) {
-    Order& order = it->second;
-    if (order.status != "FILLED_CLOSE_WAIT" && order.status != "FILLED_CLOSE_IMMEDIATE") {
-      continue;
-    }
+// Checks the TP of the long level at tick and frees the level once it has
+// filled. Returns false as CheckLongPlaceFill does.
+bool Strategy::CheckLongTpFill(int64_t tick) {
+  Order* level = long_grid_ladder_.find(tick);
+  if (level == nullptr) return true;
+  Order& order = *level;
+  if (order.status != OrderStatus::kFilledCloseWait &&
+      order.status != OrderStatus::kFilledCloseImmediate) {
+    return true;
+  }
 
-    Order tmp = it->second;
-    tmp.id = tmp.tpId;
-    bool tp = false;
-    if (order.status == "FILLED_CLOSE_IMMEDIATE") {
+  Order tmp = TpLeg(order);
+  bool tp = false;
+  if (order.status == OrderStatus::kFilledCloseImmediate) {
+    tp = true;
+  } else if (QueryOrderStatus(tmp)) {
+    order.tpId = tmp.id;
+    INFO("Check Filled tp order: " << tmp.price
+                                   << ", key: " << TickPrice(tick)
+                                   << ", tmp.id: " << tmp.id
+                                   << ", status: " << tmp.status);
+    if (tmp.status == OrderStatus::kFilled) {
       tp = true;
-    } else if (client_->detail(tmp)) {
-      INFO("Check Filled tp order: " << tmp.price << ", key: " << it->first
-                                     << ", tmp.id: " << tmp.id
-                                     << ", status: " << tmp.status);
-      if (tmp.status == "FILLED") {
-        tp = true;
-      } else if (tmp.status == "FAILED") {
-        ERROR("tp order failed: " << it->first);
-        long_grid_order_list_.erase(it);
-        break;
-      } else if (tmp.status == "NEW") {
-        float tp_price =
-            std::max(current_fix_long_price_, order.price) + order_interval_;
-        if (tmp.tp_price > tp_price + PRICE_ACCURACY_FLOAT && order.price > 0) {
-          DEBUG("TRADE update tp at: " << order.tp_price << " " << tp_price);
-          order.size = grid_size_;
-          order.tp_price = tp_price;
-          order.side = "SELL";
-          order.positionSide = "LONG";
-          order.type = "LIMIT";
-          if (!client_->tpOrder(order)) {
-            NOTICE("Failed to update long TP order for " << it->first);
-            continue;
-          } else {
-            client_->cancelOrder(tmp.id);
-            SyncTpOrderId(order);
-            NOTICE("Updating long TP order ok for "
-                   << it->first << " price: " << tmp.tp_price << " " << tp_price
-                   << "id: " << tmp.id << " " << order.tpId);
-          }
-        }
-        DEBUG("tp order still NEW: " << it->first);
-        break;
-      } else if (tmp.status == "PARTIALLY_FILLED") {
-        DEBUG("tp order PARTIALLY_FILLED: " << it->first);
-        break;
-      } else if (tmp.status == "CANCELED") {
-        DEBUG("place order CANCELED: " << it->first);
-        order.status = "IDLE";
-        break;
-      } else {
-        ERROR("tp order failed: " << it->first << ", id: " << tmp.id
-                                  << ", status: " << tmp.status);
-        break;
+    } else if (tmp.status == OrderStatus::kFailed) {
+      ERROR("tp order failed: " << TickPrice(tick));
+      long_grid_ladder_.erase(tick);
+      return false;
+    } else if (tmp.status == OrderStatus::kNew) {
+      float tp_price =
+          std::max<float>(current_fix_long_price_, order.price) +
+          order_interval_;
+      if (tmp.tp_price > tp_price + PRICE_ACCURACY_FLOAT && order.price > 0) {
+        DEBUG("TRADE update tp at: " << order.tp_price << " " << tp_price
+                                     << ", id: " << tmp.id);
+        WantTakeProfit(tick, order, PositionSide::kLong, tp_price, tmp.id);
       }
+      DEBUG("tp order still NEW: " << TickPrice(tick));
+      return false;
+    } else if (tmp.status == OrderStatus::kPartiallyFilled) {
+      DEBUG("tp order PARTIALLY_FILLED: " << TickPrice(tick));
+      return false;
+    } else if (tmp.status == OrderStatus::kCanceled) {
+      DEBUG("place order CANCELED: " << TickPrice(tick));
+      order.status = OrderStatus::kIdle;
+      return false;
+    } else {
+      ERROR("tp order failed: " << TickPrice(tick) << ", id: " << tmp.id
+                                << ", status: " << tmp.status);
+      return false;
     }
+  }
 
-    if (tp) {
-      ++success_trades_total_;
-      ++success_trades_daily_;
-      NOTICE("TRADE long  tp success: " << success_trades_total_ << " "
-                                        << it->first << " <-> "
-                                        << it->second.tp_price);
-      it->second.status = "IDLE";
-      continue;
-    }
+  if (tp) {
+    ++success_trades_total_;
+    ++success_trades_daily_;
+    NOTICE("TRADE long  tp success: " << success_trades_total_ << " "
+                                      << TickPrice(tick) << " <-> "
+                                      << order.tp_price);
+    Journal::instance().order(JournalEvent::kFill, instId_, TpLeg(order),
+                              order.price.raw);
+    order.status = OrderStatus::kIdle;
   }
+  return true;
 }
 
-void Strategy::CheckFilledShortOrders() {
-  for (auto it = short_grid_order_list_.begin();
-       it != short_grid_order_list_.end(); ++it) {
-    Order& order = it->second;
-    if (order.status != "NEW" && order.status != "PARTIALLY_FILLED" &&
-        order.status != "FILLED_OPEN_IMMEDIATE") {
-      continue;
-    }
+bool Strategy::CheckShortPlaceFill(int64_t tick) {
+  Order* level = short_grid_ladder_.find(tick);
+  if (level == nullptr) return true;
+  Order& order = *level;
+  if (order.status != OrderStatus::kNew &&
+      order.status != OrderStatus::kPartiallyFilled &&
+      order.status != OrderStatus::kFilledOpenImmediate) {
+    return true;
+  }
 
-    bool tp = false;
-    if (order.status == "FILLED_OPEN_IMMEDIATE") {
+  bool tp = false;
+  if (order.status == OrderStatus::kFilledOpenImmediate) {
+    tp = true;
+  } else if (QueryOrderStatus(order)) {
+    INFO("Check Filled place order: " << order.price
+                                      << ", key: " << TickPrice(tick)
+                                      << ", order.id: " << order.id
+                                      << ", status: " << order.status);
+    if (order.status == OrderStatus::kFilled) {
+      NOTICE("TRADE short place order FILLED: " << TickPrice(tick)
+                                                << ", price: "
+                                                << order.price);
+      Journal::instance().order(JournalEvent::kFill, instId_, order);
       tp = true;
-    } else if (client_->detail(order)) {
-      INFO("Check Filled place order: " << order.price << ", key: " << it->first
-                                        << ", order.id: " << order.id
-                                        << ", status: " << order.status);
-      if (order.status == "FILLED") {
-        NOTICE("TRADE short place order FILLED: " << it->first << ", price: "
-                                                  << order.price);
-        tp = true;
-      } else if (order.status == "FAILED") {
-        ERROR("place order failed: " << it->first);
-        short_grid_order_list_.erase(it);
-        break;
-      } else if (order.status == "NEW") {
-        DEBUG("place order still NEW: " << it->first);
-        break;
-      } else if (order.status == "PARTIALLY_FILLED") {
-        DEBUG("place order PARTIALLY_FILLED: " << it->first);
-        break;
-      } else if (order.status == "CANCELED") {
-        DEBUG("place order CANCELED: " << it->first);
-        order.status = "IDLE";
-        break;
-      } else {
-        ERROR("place order failed: " << it->first << ", id: " << order.id
-                                     << ", status: " << order.status);
-        break;
-      }
+    } else if (order.status == OrderStatus::kFailed) {
+      ERROR("place order failed: " << TickPrice(tick));
+      short_grid_ladder_.erase(tick);
+      return false;
+    } else if (order.status == OrderStatus::kNew) {
+      DEBUG("place order still NEW: " << TickPrice(tick));
+      return false;
+    } else if (order.status == OrderStatus::kPartiallyFilled) {
+      DEBUG("place order PARTIALLY_FILLED: " << TickPrice(tick));
+      return false;
+    } else if (order.status == OrderStatus::kCanceled) {
+      DEBUG("place order CANCELED: " << TickPrice(tick));
+      order.status = OrderStatus::kIdle;
+      return false;
+    } else {
+      ERROR("place order failed: " << TickPrice(tick) << ", id: " << order.id
+                                   << ", status: " << order.status);
+      return false;
     }
+  }
 
-    if (tp) {
-      int try_count = 10;
-      for (int i = 0; i < try_count; ++i) {
-        float tp_price =
-            std::min(current_fix_short_price_, order.price) - order_interval_;
-        order.size = grid_size_;
-        order.tp_price = tp_price;
-        order.side = "BUY";
-        order.positionSide = "SHORT";
-        order.type = "LIMIT";
-        DEBUG("TRADE Placing short tp order at price: " << order.tp_price);
-        if (!client_->tpOrder(order)) {
-          UpdatePrice();
-        } else {
-          SyncTpOrderId(order);
-          DEBUG("TRADE Place TP order ok for "
-                << it->first << " " << order.price << " " << order_interval_
-                << " " << current_fix_short_price_ << ", tp_price: " << tp_price
-                << ", tp id: " << order.tpId);
-          break;
-        }
-      }
-    }
+  if (tp) {
+    float tp_price =
+        std::min<float>(current_fix_short_price_, order.price) -
+        order_interval_;
+    DEBUG("TRADE Placing short tp order at price: " << tp_price);
+    order.status = OrderStatus::kFilledOpenImmediate;
+    WantTakeProfit(tick, order, PositionSide::kShort, tp_price, 0);
   }
+  return true;
+}
 
-  for (auto it = short_grid_order_list_.rbegin();
-       it != short_grid_order_list_.rend(); ++it) {
-    Order& order = it->second;
-    if (order.status != "FILLED_CLOSE_WAIT" && order.status != "FILLED_CLOSE_IMMEDIATE") {
-      continue;
-    }
+bool Strategy::CheckShortTpFill(int64_t tick) {
+  Order* level = short_grid_ladder_.find(tick);
+  if (level == nullptr) return true;
+  Order& order = *level;
+  if (order.status != OrderStatus::kFilledCloseWait &&
+      order.status != OrderStatus::kFilledCloseImmediate) {
+    return true;
+  }
 
-    Order tmp = it->second;
-    tmp.id = tmp.tpId;
-    bool tp = false;
-    if (order.status == "FILLED_CLOSE_IMMEDIATE") {
+  Order tmp = TpLeg(order);
+  bool tp = false;
+  if (order.status == OrderStatus::kFilledCloseImmediate) {
+    tp = true;
+  } else if (QueryOrderStatus(tmp)) {
+    order.tpId = tmp.id;
+    INFO("Check Filled tp order: " << tmp.price
+                                   << ", key: " << TickPrice(tick)
+                                   << ", tmp.id: " << tmp.id
+                                   << ", status: " << tmp.status);
+    if (tmp.status == OrderStatus::kFilled) {
       tp = true;
-    } else if (client_->detail(tmp)) {
-      INFO("Check Filled tp order: " << tmp.price << ", key: " << it->first
-                                     << ", tmp.id: " << tmp.id
-                                     << ", status: " << tmp.status);
-      if (tmp.status == "FILLED") {
-        tp = true;
-      } else if (tmp.status == "FAILED") {
-        ERROR("tp order failed: " << it->first);
-        auto it_to_erase = std::prev(it.base());
-        short_grid_order_list_.erase(it_to_erase);
-        break;
-      } else if (tmp.status == "NEW") {
-        float tp_price =
-            std::min(current_fix_short_price_, order.price) - order_interval_;
-        if (tmp.tp_price < tp_price - PRICE_ACCURACY_FLOAT && order.price > 0) {
-          DEBUG("TRADE update tp at: " << order.tp_price << " " << tp_price);
-          order.size = grid_size_;
-          order.tp_price = tp_price;
-          order.side = "BUY";
-          order.positionSide = "SHORT";
-          order.type = "LIMIT";
-          if (!client_->tpOrder(order)) {
-            NOTICE("Failed to place TP order for " << it->first);
-            continue;
-          } else {
-            client_->cancelOrder(tmp.id);
-            SyncTpOrderId(order);
-            NOTICE("Updating short TP order ok for "
-                   << it->first << " price: " << tmp.tp_price << " " << tp_price
-                   << "id: " << tmp.id << " " << order.tpId);
-          }
-        }
-        DEBUG("tp order still NEW: " << it->first);
-        break;
-      } else if (tmp.status == "PARTIALLY_FILLED") {
-        DEBUG("tp order PARTIALLY_FILLED: " << it->first);
-        break;
-      } else if (tmp.status == "CANCELED") {
-        DEBUG("tp order CANCELED: " << it->first);
-        order.status = "IDLE";
-        break;
-      } else {
-        ERROR("tp order failed: " << it->first << ", id: " << tmp.id
-                                  << ", status: " << tmp.status);
-        break;
+    } else if (tmp.status == OrderStatus::kFailed) {
+      ERROR("tp order failed: " << TickPrice(tick));
+      short_grid_ladder_.erase(tick);
+      return false;
+    } else if (tmp.status == OrderStatus::kNew) {
+      float tp_price =
+          std::min<float>(current_fix_short_price_, order.price) -
+          order_interval_;
+      if (tmp.tp_price < tp_price - PRICE_ACCURACY_FLOAT && order.price > 0) {
+        DEBUG("TRADE update tp at: " << order.tp_price << " " << tp_price
+                                     << ", id: " << tmp.id);
+        WantTakeProfit(tick, order, PositionSide::kShort, tp_price, tmp.id);
       }
+      DEBUG("tp order still NEW: " << TickPrice(tick));
+      return false;
+    } else if (tmp.status == OrderStatus::kPartiallyFilled) {
+      DEBUG("tp order PARTIALLY_FILLED: " << TickPrice(tick));
+      return false;
+    } else if (tmp.status == OrderStatus::kCanceled) {
+      DEBUG("tp order CANCELED: " << TickPrice(tick));
+      order.status = OrderStatus::kIdle;
+      return false;
+    } else {
+      ERROR("tp order failed: " << TickPrice(tick) << ", id: " << tmp.id
+                                << ", status: " << tmp.status);
+      return false;
     }
-    if (tp) {
-      ++success_trades_total_;
-      ++success_trades_daily_;
-      NOTICE("TRADE short tp success: " << success_trades_total_ << " "
-                                        << it->first << " <-> "
-                                        << it->second.tp_price);
-      it->second.status = "IDLE";
-      continue;
-    }
   }
+  if (tp) {
+    ++success_trades_total_;
+    ++success_trades_daily_;
+    NOTICE("TRADE short tp success: " << success_trades_total_ << " "
+                                      << TickPrice(tick) << " <-> "
+                                      << order.tp_price);
+    Journal::instance().order(JournalEvent::kFill, instId_, TpLeg(order),
+                              order.price.raw);
+    order.status = OrderStatus::kIdle;
+  }
+  return true;
 }
 
 void Strategy::RunLongGrid() {
-  DeleteLongTpOrders();
-  DeleteLongPlaceOrders();
   CountLongReduceSize();
   CheckFilledLongOrders();
-  MakeLongPlaceOrders();
-  MakeLongTpOrders();
+  PlanLongPlaceOrders();
+  PlanLongTpOrders();
+
+  // Grid-sized orders drifting more than two ladders away get cancelled.
+  standx::KeepBand band;
+  band.position_side = PositionSide::kLong;
+  band.size = grid_size_;
+  band.reduce_only = false;
+  band.lo_tick = current_fix_long_tick_ - params_.order_num * 2;
+  reconciler_.keep(band);
+  band.reduce_only = true;
+  band.lo_tick = INT64_MIN;
+  band.hi_tick = current_fix_long_tick_ + params_.order_num * 2;
+  reconciler_.keep(band);
 }
 
 void Strategy::RunShortGrid() {
-  DeleteShortTpOrders();
-  DeleteShortPlaceOrders();
   CountShortReduceSize();
   CheckFilledShortOrders();
-  MakeShortPlaceOrders();
-  MakeShortTpOrders();
-}
-
-void Strategy::DeleteLongTpOrders() {
-  for (auto it = unfilled_orders_.begin(); it != unfilled_orders_.end();) {
-    auto& order = *it;
-    if (order.is_reduce_only && order.size == grid_size_ &&
-        order.price >
-            current_fix_long_price_ + order_interval_ * ORDER_NUM * 2) {
-      client_->cancelOrder(order.id);
-      DEBUG("Cancel long tp order " << order.contract << " " << order.id
-                                    << ", price: " << order.price
-                                    << ", current_price_: " << current_price_);
-      it = unfilled_orders_.erase(it);
-    } else {
-      ++it;
-    }
+  PlanShortPlaceOrders();
+  PlanShortTpOrders();
+
+  int64_t fix_short_tick = current_fix_long_tick_ + 1;
+  standx::KeepBand band;
+  band.position_side = PositionSide::kShort;
+  band.size = grid_size_;
+  band.reduce_only = false;
+  band.hi_tick = fix_short_tick + params_.order_num * 2;
+  reconciler_.keep(band);
+  band.reduce_only = true;
+  band.lo_tick = fix_short_tick - params_.order_num * 2;
+  band.hi_tick = INT64_MAX;
+  reconciler_.keep(band);
+}
+
+void Strategy::WantTakeProfit(int64_t level_tick, const Order& level,
+                              PositionSide position_side, float tp_price,
+                              int64_t replaces) {
+  standx::DesiredOrder desired;
+  desired.order = level;
+  desired.order.size = grid_size_;
+  desired.order.tp_price = tp_price;
+  desired.order.side = position_side == PositionSide::kLong ? OrderSide::kSell
+                                                            : OrderSide::kBuy;
+  desired.order.positionSide = position_side;
+  desired.order.type = OrderType::kLimit;
+  desired.order.is_reduce_only = true;
+  desired.tick = PriceTick(tp_price);
+  desired.level_tick = level_tick;
+  desired.replaces = replaces;
+  desired.intent = standx::GridIntent::kTakeProfit;
+  reconciler_.want(desired);
+  if (replaces == 0) {
+    (position_side == PositionSide::kLong ? long_reduce_size_
+                                          : short_reduce_size_) += grid_size_;
   }
 }
 
-void Strategy::DeleteLongPlaceOrders() {
-  for (auto it = unfilled_orders_.begin(); it != unfilled_orders_.end();) {
-    auto& order = *it;
-    if (!order.is_reduce_only && order.size == grid_size_ &&
-        order.price <
-            current_fix_long_price_ - order_interval_ * ORDER_NUM * 2) {
-      client_->cancelOrder(order.id);
-      auto price_str = adjustDecimalPlaces(order.price, order_price_round_);
-      auto itr = long_grid_order_list_.find(price_str);
-      if (itr != long_grid_order_list_.end()) {
-        itr->second.status = "IDLE";
-        DEBUG("Erase long grid order list for price: "
-              << order.price << ", key: " << price_str);
-      }
-      it = unfilled_orders_.erase(it);
-      DEBUG("Cancel long place order too far price: "
-            << order.price << ", current_price_: " << current_price_);
-    } else {
-      ++it;
-    }
+void Strategy::ReleaseLevel(const Order& order) {
+  // A cancelled place order frees its level for a later re-place.
+  if (order.is_reduce_only) return;
+  int64_t tick = PriceTick(order.price);
+  if (Order* level = Ladder(order.positionSide).find(tick)) {
+    level->status = OrderStatus::kIdle;
+    DEBUG("Reset " << order.positionSide << " grid level for price: "
+                   << order.price << ", tick: " << tick);
   }
 }
 
-void Strategy::DeleteShortTpOrders() {
-  for (auto it = unfilled_orders_.begin(); it != unfilled_orders_.end();) {
-    auto& order = *it;
-    if (order.is_reduce_only && order.size == grid_size_ &&
-        order.price <
-            current_fix_short_price_ - order_interval_ * ORDER_NUM * 2) {
-      client_->cancelOrder(order.id);
-      DEBUG("Cancel short tp order " << order.contract << " " << order.id
-                                     << ", price: " << order.price
-                                     << ", current_price_: " << current_price_);
-      it = unfilled_orders_.erase(it);
-    } else {
-      ++it;
+void Strategy::DispatchGridActions(const standx::GridActions& actions) {
+  if (actions.empty()) return;
+  DEBUG("Grid dispatch: cancel " << actions.cancel.size() << ", place "
+                                 << actions.place.size() << ", amend "
+                                 << actions.amend.size());
+
+  // Amends go out first; each is a cancel-replace chained on the event loop,
+  // so a repriced TP never doubles the reduce-only size on the book.
+  std::vector<standx::DesiredOrder> amending;
+  std::vector<std::future<standx::AmendStatus>> amended;
+  amending.reserve(actions.amend.size());
+  amended.reserve(actions.amend.size());
+  for (const auto& amend : actions.amend) {
+    amending.push_back(amend.target);
+    standx::DesiredOrder& target = amending.back();
+    amended.push_back(client_->amendOrderAsync(
+        amend.live.id, target.order,
+        target.intent != standx::GridIntent::kOpen));
+  }
+
+  std::vector<int64_t> cancel_ids;
+  for (const auto& order : actions.cancel) {
+    DEBUG("Cancel " << order.positionSide
+                    << (order.is_reduce_only ? " tp" : " place") << " order "
+                    << instId_ << " " << order.id << ", price: " << order.price
+                    << ", current_price_: " << current_price_);
+    cancel_ids.push_back(order.id);
+  }
+  std::vector<bool> cancelled;
+  std::vector<int64_t> filled;
+  if (!cancel_ids.empty()) {
+    cancelled = client_->cancelOrders(cancel_ids, &filled);
+  }
+  for (size_t i = 0; i < actions.cancel.size(); ++i) {
+    if (std::find(filled.begin(), filled.end(), cancel_ids[i]) !=
+        filled.end()) {
+      // Filled before the cancel reached it: the level and book entry stay
+      // for the next fill check, which handles it like any other fill.
+      DEBUG("Order " << cancel_ids[i] << " filled before its cancel");
+      continue;
+    }
+    if (!cancelled[i]) {
+      // Still live, or just filled: the level and book entry stay until the
+      // next fill check or open-orders poll says which.
+      ERROR("Cancel order failed: " << cancel_ids[i]);
+      Journal::instance().order(JournalEvent::kCancelFailed, instId_,
+                                actions.cancel[i]);
+      continue;
+    }
+    Journal::instance().order(JournalEvent::kCancel, instId_,
+                              actions.cancel[i]);
+    ReleaseLevel(actions.cancel[i]);
+    open_orders_.erase(actions.cancel[i].id);
+  }
+
+  // Every placement is on the wire before the first answer is awaited.
+  std::vector<standx::DesiredOrder> placing(actions.place);
+  std::vector<std::future<bool>> futures;
+  futures.reserve(placing.size());
+  for (auto& desired : placing) {
+    futures.push_back(desired.intent == standx::GridIntent::kOpen
+                          ? client_->placeOrderAsync(desired.order)
+                          : client_->tpOrderAsync(desired.order));
+  }
+  std::vector<bool> placed;
+  placed.reserve(placing.size() + amending.size());
+  for (auto& future : futures) placed.push_back(future.get());
+
+  // An amend whose cancel went through goes on as a placement.
+  for (size_t i = 0; i < amending.size(); ++i) {
+    const Order& live = actions.amend[i].live;
+    standx::AmendStatus status = amended[i].get();
+    if (status == standx::AmendStatus::kRejected) {
+      // The old order may have just filled; leave it to the next check.
+      Journal::instance().order(JournalEvent::kCancelFailed, instId_, live);
+      continue;
     }
+    Journal::instance().order(JournalEvent::kCancel, instId_, live);
+    ReleaseLevel(live);
+    open_orders_.erase(live.id);
+    placing.push_back(amending[i]);
+    placed.push_back(status == standx::AmendStatus::kAmended);
+  }
+
+  // The exchange ids of all accepted placements are looked up together.
+  std::vector<Order> resolved;
+  ResolvePlacedOrders(placing, placed, resolved);
+  for (size_t i = 0; i < placing.size(); ++i) {
+    ApplyPlaced(placing[i], placed[i], resolved[i]);
   }
 }
 
-void Strategy::DeleteShortPlaceOrders() {
-  for (auto it = unfilled_orders_.begin(); it != unfilled_orders_.end();) {
-    auto& order = *it;
-    if (!order.is_reduce_only && order.size == grid_size_ &&
-        order.price >
-            current_fix_short_price_ + order_interval_ * ORDER_NUM * 2) {
-      client_->cancelOrder(order.id);
-      auto price_str = adjustDecimalPlaces(order.price, order_price_round_);
-      auto itr = short_grid_order_list_.find(price_str);
-      if (itr != short_grid_order_list_.end()) {
-        itr->second.status = "IDLE";
-        DEBUG("Erase short grid order list for price: "
-              << order.price << ", key: " << price_str);
+void Strategy::ApplyPlaced(standx::DesiredOrder& desired, bool ok,
+                           const Order& resolved) {
+  Order& order = desired.order;
+  auto& ladder = Ladder(order.positionSide);
+
+  switch (desired.intent) {
+    case standx::GridIntent::kOpen:
+      if (!ok) {
+        NOTICE("Failed to place " << order.positionSide << " order");
+        Journal::instance().order(JournalEvent::kReject, instId_, order);
+        return;
       }
-      it = unfilled_orders_.erase(it);
-      DEBUG("Cancel short place order too far price: "
-            << order.price << ", current_price_: " << current_price_);
-    } else {
-      ++it;
+      SyncPlacedOrderId(order, resolved);
+      ladder.insert(desired.level_tick, order);
+      Journal::instance().order(JournalEvent::kPlace, instId_, order);
+      NOTICE("TRADE Place " << order.positionSide << " Order: " << instId_
+                            << " " << order.id << ", size: " << order.size
+                            << ", tick: " << desired.level_tick
+                            << ", price: " << order.price
+                            << ", current_price_: " << current_price_);
+      return;
+
+    case standx::GridIntent::kTakeProfit: {
+      Order* level = ladder.find(desired.level_tick);
+      if (level == nullptr) {
+        WARNING("TP level no longer in the grid, tick: " << desired.level_tick);
+        return;
+      }
+      if (ok && SyncTpOrderId(order, resolved)) {
+        *level = order;
+        Journal::instance().order(JournalEvent::kPlace, instId_, TpLeg(order),
+                                  order.price.raw);
+        DEBUG("TRADE Place TP order ok for "
+              << TickPrice(desired.level_tick) << " " << order.price
+              << ", tp_price: " << order.tp_price << ", tp id: " << order.tpId
+              << ", replaces: " << desired.replaces);
+      } else {
+        level->status = OrderStatus::kFilledOpenImmediate;
+        Journal::instance().order(JournalEvent::kReject, instId_, TpLeg(order),
+                                  order.price.raw);
+        NOTICE("Failed to place " << order.positionSide << " TP order for "
+                                  << TickPrice(desired.level_tick));
+      }
+      return;
     }
+
+    case standx::GridIntent::kCover:
+      if (!ok || !SyncTpOrderId(order, resolved)) {
+        ERROR("Failed to place " << order.positionSide << " TP order");
+        Journal::instance().order(JournalEvent::kReject, instId_, TpLeg(order),
+                                  order.price.raw);
+        return;
+      }
+      Journal::instance().order(JournalEvent::kPlace, instId_, TpLeg(order),
+                                order.price.raw);
+      if (Order* level = ladder.find(desired.level_tick)) {
+        level->tpId = order.tpId;
+        DEBUG("Update place tpId for tick: " << desired.level_tick
+                                             << ", tpId: " << order.tpId);
+      } else {
+        ladder.insert(desired.level_tick, order);
+        DEBUG("Update insert tpId for tick: " << desired.level_tick
+                                              << ", tpId: " << order.tpId);
+      }
+      NOTICE("TRADE Place TP order: " << instId_ << " " << order.tpId
+                                      << ", size: " << order.size
+                                      << ", price: " << order.tp_price);
+      return;
   }
 }
 
 void Strategy::CountLongReduceSize() {
-  long_reduce_size_ = std::accumulate(
-      unfilled_orders_.begin(), unfilled_orders_.end(), 0.0f,
-      [](float sum, const auto& order) {
-        return (order.is_reduce_only && order.positionSide == "LONG")
-                   ? sum + order.size
-                   : sum;
-      });
+  long_reduce_size_ = open_orders_.reduce_only_size(PositionSide::kLong);
 }
 
 void Strategy::CountShortReduceSize() {
-  short_reduce_size_ = std::accumulate(
-      unfilled_orders_.begin(), unfilled_orders_.end(), 0.0f,
-      [](float sum, const auto& order) {
-        return (order.is_reduce_only && order.positionSide == "SHORT")
-                   ? sum + fabs(order.size)
-                   : sum;
-      });
+  short_reduce_size_ = open_orders_.reduce_only_size(PositionSide::kShort);
 }
 
 void Strategy::InitLongPlaceOrders() {
-  for (auto& order : unfilled_orders_) {
-    if (!order.is_reduce_only && order.positionSide == "LONG") {
-      auto price_str = adjustDecimalPlaces(order.price, order_price_round_);
-      if (long_grid_order_list_.find(price_str) ==
-          long_grid_order_list_.end()) {
-        NOTICE("Init place long order not in grid list, price: "
-               << order.price << ", price_str: " << price_str);
-        long_grid_order_list_[price_str] = order;
-      }
+  open_orders_.for_each([this](const Order& order) {
+    if (order.is_reduce_only ||
+        order.positionSide != PositionSide::kLong) {
+      return;
     }
-  }
+    int64_t tick = PriceTick(order.price);
+    if (long_grid_ladder_.find(tick) != nullptr) return;
+    NOTICE("Init place long order not in grid ladder, price: "
+           << order.price << ", tick: " << tick);
+    long_grid_ladder_.insert(tick, order);
+  });
 }
 
 void Strategy::InitShortPlaceOrders() {
-  for (auto& order : unfilled_orders_) {
-    if (!order.is_reduce_only && order.positionSide == "SHORT") {
-      auto price_str = adjustDecimalPlaces(order.price + order_interval_,
-                                           order_price_round_);
-      if (short_grid_order_list_.find(price_str) ==
-          short_grid_order_list_.end()) {
-        NOTICE("Init place short order not in grid list, price: "
-               << order.price << ", price_str: " << price_str);
-        short_grid_order_list_[price_str] = order;
-      }
+  open_orders_.for_each([this](const Order& order) {
+    if (order.is_reduce_only ||
+        order.positionSide != PositionSide::kShort) {
+      return;
     }
-  }
+    int64_t tick = PriceTick(order.price + order_interval_);
+    if (short_grid_ladder_.find(tick) != nullptr) return;
+    NOTICE("Init place short order not in grid ladder, price: "
+           << order.price << ", tick: " << tick);
+    short_grid_ladder_.insert(tick, order);
+  });
 }
 
 void Strategy::InitLongTpOrders() {
-  for (auto& order : unfilled_orders_) {
-    if (order.is_reduce_only && order.positionSide == "LONG") {
-      auto price_str = adjustDecimalPlaces(order.price - order_interval_,
-                                           order_price_round_);
-      if (long_grid_order_list_.find(price_str) ==
-          long_grid_order_list_.end()) {
-        NOTICE("Init tp long order not in grid list, price: "
-               << order.price << ", price_str: " << price_str);
-        order.status = "FILLED";
-        order.tpId = order.id;
-        order.tp_price = order.price;
-        order.price = 0;
-        long_grid_order_list_[price_str] = order;
-      }
+  open_orders_.for_each([this](const Order& order) {
+    if (!order.is_reduce_only ||
+        order.positionSide != PositionSide::kLong) {
+      return;
     }
-  }
+    int64_t tick = PriceTick(order.price - order_interval_);
+    if (long_grid_ladder_.find(tick) != nullptr) return;
+    NOTICE("Init tp long order not in grid ladder, price: "
+           << order.price << ", tick: " << tick);
+    Order level = order;
+    level.status = OrderStatus::kFilled;
+    level.tpId = order.id;
+    level.tp_price = order.price;
+    level.price = 0;
+    long_grid_ladder_.insert(tick, level);
+  });
 }
 
 void Strategy::InitShortTpOrders() {
-  for (auto& order : unfilled_orders_) {
-    if (order.is_reduce_only && order.positionSide == "SHORT") {
-      auto price_str = adjustDecimalPlaces(order.price + order_interval_,
-                                           order_price_round_);
-      if (short_grid_order_list_.find(price_str) ==
-          short_grid_order_list_.end()) {
-        NOTICE("Init tp short order not in grid list, price: "
-               << order.price << ", price_str: " << price_str);
-        order.status = "FILLED";
-        order.tpId = order.id;
-        order.tp_price = order.price;
-        order.price = 0;
-        short_grid_order_list_[price_str] = order;
-      }
+  open_orders_.for_each([this](const Order& order) {
+    if (!order.is_reduce_only ||
+        order.positionSide != PositionSide::kShort) {
+      return;
     }
-  }
+    int64_t tick = PriceTick(order.price + order_interval_);
+    if (short_grid_ladder_.find(tick) != nullptr) return;
+    NOTICE("Init tp short order not in grid ladder, price: "
+           << order.price << ", tick: " << tick);
+    Order level = order;
+    level.status = OrderStatus::kFilled;
+    level.tpId = order.id;
+    level.tp_price = order.price;
+    level.price = 0;
+    short_grid_ladder_.insert(tick, level);
+  });
 }
 
-void Strategy::MakeLongPlaceOrders() {
-  for (int i = 0; i < ORDER_NUM; ++i) {
-    float place_price = current_fix_long_price_ - order_interval_ * (i);
-    auto place_price_str = adjustDecimalPlaces(place_price, order_price_round_);
+void Strategy::PlanLongPlaceOrders() {
+  for (int i = 0; i < params_.order_num; ++i) {
+    int64_t place_tick = current_fix_long_tick_ - i;
+    float place_price = TickPrice(place_tick);
     if (current_price_ - place_price < order_interval_ * 0.5) continue;
 
-    bool place_order_exists = std::any_of(
-        unfilled_orders_.begin(), unfilled_orders_.end(),
-        [&](const auto& order) {
-          return !order.is_reduce_only && order.positionSide == "LONG" &&
-                 areFloatsEqual(order.price, place_price, PRICE_ACCURACY_FLOAT);
-        });
-
-    if (place_order_exists) {
-      continue;
-    }
-
     bool place_order_idle = false;
-    auto it = long_grid_order_list_.find(place_price_str);
-    if (it == long_grid_order_list_.end()) {
+    const Order* level = long_grid_ladder_.find(place_tick);
+    if (level == nullptr) {
       place_order_idle = true;
-      DEBUG("place order not exist " << place_price_str);
-    } else if (it->second.status == "IDLE") {
+      DEBUG("place order not exist " << place_price);
+    } else if (level->status == OrderStatus::kIdle) {
       place_order_idle = true;
-      DEBUG("place order IDLE " << place_price_str);
+      DEBUG("place order IDLE " << place_price);
     } else {
-      DEBUG("place order found in grid list, status: "
-            << it->second.status << ", price: " << it->second.price);
+      DEBUG("place order found in grid ladder, status: "
+            << level->status << ", price: " << level->price);
     }
 
     if (place_order_idle) {
       Order order;
-      order.side = "BUY";
-      order.positionSide = "LONG";
-      order.type = "LIMIT";
+      order.side = OrderSide::kBuy;
+      order.positionSide = PositionSide::kLong;
+      order.type = OrderType::kLimit;
       order.price = place_price;
       order.size = grid_size_;
-      order.status = "NEW";
+      order.status = OrderStatus::kNew;
       DEBUG("TRADE Making long place order at price: " << place_price);
-      if (client_->placeOrder(order)) {
-        SyncPlacedOrderId(order);
-        long_grid_order_list_[place_price_str] = order;
-        NOTICE("TRADE Place Long Order: "
-               << order.contract << " " << order.id << ", size: " << order.size
-               << ", key: " << place_price_str << ", price: " << order.price
-               << ", current_price_: " << current_price_);
-      } else {
-        NOTICE("Failed to place long order");
-      }
+      standx::DesiredOrder desired;
+      desired.order = order;
+      desired.tick = place_tick;
+      desired.level_tick = place_tick;
+      desired.intent = standx::GridIntent::kOpen;
+      reconciler_.want(desired);
     }
   }
 }
 
-void Strategy::MakeShortPlaceOrders() {
-  for (int i = 0; i < ORDER_NUM; ++i) {
-    float place_price = current_fix_long_price_ + order_interval_ * (i);
-    auto place_price_str = adjustDecimalPlaces(place_price, order_price_round_);
+void Strategy::PlanShortPlaceOrders() {
+  for (int i = 0; i < params_.order_num; ++i) {
+    int64_t place_tick = current_fix_long_tick_ + i;
+    float place_price = TickPrice(place_tick);
     if (place_price - current_price_ < order_interval_ * 0.5) continue;
 
-    bool place_order_exists = std::any_of(
-        unfilled_orders_.begin(), unfilled_orders_.end(),
-        [&](const auto& order) {
-          return !order.is_reduce_only && order.positionSide == "SHORT" &&
-                 areFloatsEqual(order.price, place_price, PRICE_ACCURACY_FLOAT);
-        });
-
-    if (place_order_exists) {
-      continue;
-    }
-
     bool place_order_idle = false;
-    auto it = short_grid_order_list_.find(place_price_str);
-    if (it == short_grid_order_list_.end()) {
+    const Order* level = short_grid_ladder_.find(place_tick);
+    if (level == nullptr) {
       place_order_idle = true;
-      DEBUG("place order not exist " << place_price_str);
-    } else if (it->second.status == "IDLE") {
+      DEBUG("place order not exist " << place_price);
+    } else if (level->status == OrderStatus::kIdle) {
       place_order_idle = true;
-      DEBUG("place order IDLE " << place_price_str);
+      DEBUG("place order IDLE " << place_price);
     } else {
-      DEBUG("place order found in grid list, status: "
-            << it->second.status << ", price: " << it->second.price);
+      DEBUG("place order found in grid ladder, status: "
+            << level->status << ", price: " << level->price);
     }
 
     if (place_order_idle) {
       Order order;
-      order.side = "SELL";
-      order.positionSide = "SHORT";
-      order.type = "LIMIT";
+      order.side = OrderSide::kSell;
+      order.positionSide = PositionSide::kShort;
+      order.type = OrderType::kLimit;
       order.price = place_price;
       order.size = grid_size_;
-      order.status = "NEW";
+      order.status = OrderStatus::kNew;
       DEBUG("TRADE Making short place order at price: " << place_price);
-      if (client_->placeOrder(order)) {
-        SyncPlacedOrderId(order);
-        short_grid_order_list_[place_price_str] = order;
-        NOTICE("TRADE Place Short Order: "
-               << order.contract << " " << order.id << ", size: " << order.size
-               << ", key: " << place_price_str << ", price: " << order.price
-               << ", current_price_: " << current_price_);
-      } else {
-        NOTICE("Failed to place short order");
-      }
+      standx::DesiredOrder desired;
+      desired.order = order;
+      desired.tick = place_tick;
+      desired.level_tick = place_tick;
+      desired.intent = standx::GridIntent::kOpen;
+      reconciler_.want(desired);
     }
   }
 }
 
-void Strategy::SyncPlacedOrderId(Order& order) {
-  DEBUG("Sync placed order, price: " << order.price << ", side: " << order.side
-                                     << ", positionSide: "
-                                     << order.positionSide);
-  for (int i = 0; i < 5; ++i) {
-    SLEEP_MS(1000);
-    CheckUnfilledOrders();
-    for (auto& u : unfilled_orders_) {
-      DEBUG("Sync placed order, u price: "
-            << u.price << ", side: " << u.side << ", status: " << u.status
-            << ", positionSide: " << u.positionSide);
-      if (u.side == order.side && u.status == "NEW" &&
-          areFloatsEqual(u.price, order.price, PRICE_ACCURACY_FLOAT)) {
-        order.id = u.id;
-        order.status = "NEW";
-        DEBUG("Synced placed order with unfilled list, price: "
-              << order.price << ", id: " << order.id);
-        return;
-      }
+bool Strategy::LookupClientOrder(const ClientOrderId& cl_ord_id,
+                                 Order& out) {
+  if (order_stream_ && order_stream_->is_connected()) {
+    standx::OrderState state;
+    if (order_stream_->table().find_by_client_id(cl_ord_id, state)) {
+      out.id = state.id;
+      out.status = state.status;
+      return true;
     }
   }
-  order.status = "FILLED_OPEN_IMMEDIATE";
-  DEBUG("Placed order not found in unfilled list, mark FILLED, price: "
-        << order.price);
+
+  Order probe;
+  probe.clientId = cl_ord_id;
+  if (!client_->detailByClientId(probe)) return false;
+  out.id = probe.id;
+  out.status = probe.status;
+  return true;
 }
 
-void Strategy::SyncTpOrderId(Order& order) {
-  DEBUG("Sync tp order, price: " << order.price << ", side: " << order.side
-                                 << ", positionSide: " << order.positionSide
-                                 << ", tp_price: " << order.tp_price);
-  for (int i = 0; i < 5; ++i) {
-    SLEEP_MS(1000);
-    CheckUnfilledOrders();
-    for (auto& u : unfilled_orders_) {
-      DEBUG("Sync tp order, u price: " << u.price << ", side: " << u.side
-                                       << ", status: " << u.status
-                                       << ", positionSide: " << u.positionSide);
-      if (u.is_reduce_only && u.positionSide == order.positionSide &&
-          areFloatsEqual(u.price, order.tp_price, PRICE_ACCURACY_FLOAT)) {
-        order.tpId = u.id;
-        order.status = "FILLED_CLOSE_WAIT";
-        DEBUG("Synced TP order with unfilled list, tp_price: "
-              << order.tp_price << ", tpId: " << order.tpId);
-        return;
+void Strategy::ResolvePlacedOrders(
+    const std::vector<standx::DesiredOrder>& placing,
+    const std::vector<bool>& placed, std::vector<Order>& resolved) {
+  resolved.assign(placing.size(), Order());
+  std::vector<size_t> pending;
+  for (size_t i = 0; i < placing.size(); ++i) {
+    if (!placed[i]) continue;
+    const Order& order = placing[i].order;
+    resolved[i].clientId = placing[i].intent == standx::GridIntent::kOpen
+                               ? order.clientId
+                               : order.tpClientId;
+    pending.push_back(i);
+  }
+  if (pending.empty()) return;
+
+  bool streaming = order_stream_ && order_stream_->is_connected();
+  if (streaming) {
+    // The stream reports a new order as soon as the venue has it, so wait
+    // for the events instead of polling REST. Other events seen meanwhile
+    // are posted again for the main loop.
+    auto from_stream = [&](size_t i) {
+      standx::OrderState state;
+      if (!order_stream_->table().find_by_client_id(resolved[i].clientId,
+                                                    state)) {
+        return false;
+      }
+      resolved[i].id = state.id;
+      resolved[i].status = state.status;
+      return true;
+    };
+    auto deadline = std::chrono::steady_clock::now() + kStreamResolveTimeout;
+    uint32_t seen = 0;
+    while (true) {
+      pending.erase(
+          std::remove_if(pending.begin(), pending.end(), from_stream),
+          pending.end());
+      auto left = std::chrono::ceil<std::chrono::milliseconds>(
+          deadline - std::chrono::steady_clock::now());
+      if (pending.empty() || left.count() <= 0 ||
+          (seen & standx::kEventShutdown)) {
+        break;
+      }
+      seen |= events_->wait(left) & ~standx::kEventTimer;
+    }
+    if (seen != 0) events_->post(seen);
+  }
+
+  // Whatever is left goes to REST with every probe in flight at once. With
+  // the stream up that is one round, for events lost across a reconnect;
+  // without it the venue gets three rounds to index the orders.
+  int rounds = streaming ? 1 : 3;
+  for (int round = 0; round < rounds && !pending.empty(); ++round) {
+    if (round > 0) client_->sleep(50 << (round - 1));
+    std::vector<std::future<bool>> probes;
+    probes.reserve(pending.size());
+    for (size_t i : pending) {
+      probes.push_back(client_->detailByClientIdAsync(resolved[i]));
+    }
+    std::vector<size_t> missing;
+    for (size_t k = 0; k < pending.size(); ++k) {
+      if (!probes[k].get()) {
+        resolved[pending[k]].id = 0;
+        missing.push_back(pending[k]);
       }
     }
+    pending.swap(missing);
   }
-  order.status = "FILLED_CLOSE_IMMEDIATE";
-  DEBUG("TP order not found in unfilled list, mark FILLED, tp_price: "
-        << order.tp_price);
 }
 
-void Strategy::MakeLongTpOrders() {
-  int num = 5;
+void Strategy::SyncPlacedOrderId(Order& order, const Order& resolved) {
+  DEBUG("Sync placed order, price: " << order.price << ", side: " << order.side
+                                     << ", clientId: " << order.clientId);
+  if (resolved.id == 0) {
+    // Accepted but not visible yet. The level stays NEW with no id, and the
+    // fill check looks it up by client id until it appears.
+    order.id = 0;
+    order.status = OrderStatus::kNew;
+    WARNING("Placed order not found by client id yet, price: "
+            << order.price << ", clientId: " << order.clientId);
+    return;
+  }
+
+  order.id = resolved.id;
+  if (resolved.status == OrderStatus::kFilled) {
+    order.status = OrderStatus::kFilledOpenImmediate;
+  } else if (resolved.status == OrderStatus::kCanceled ||
+             resolved.status == OrderStatus::kFailed) {
+    // ALO rejected (would have crossed); leave the level free for a retry.
+    order.status = OrderStatus::kIdle;
+  } else {
+    order.status = OrderStatus::kNew;
+    SeedOrderState(order.id, order.status);
+  }
+  DEBUG("Synced placed order, price: " << order.price << ", id: " << order.id
+                                       << ", status: " << order.status);
+}
+
+bool Strategy::SyncTpOrderId(Order& order, const Order& resolved) {
+  DEBUG("Sync tp order, price: " << order.price << ", side: " << order.side
+                                 << ", tp_price: " << order.tp_price
+                                 << ", tpClientId: " << order.tpClientId);
+  if (resolved.id == 0) {
+    // As for a place order: wait for it under its client id.
+    order.tpId = 0;
+    order.status = OrderStatus::kFilledCloseWait;
+    WARNING("TP order not found by client id yet, tp_price: "
+            << order.tp_price << ", tpClientId: " << order.tpClientId);
+    return true;
+  }
+
+  order.tpId = resolved.id;
+  if (resolved.status == OrderStatus::kFilled) {
+    order.status = OrderStatus::kFilledCloseImmediate;
+  } else if (resolved.status == OrderStatus::kCanceled ||
+             resolved.status == OrderStatus::kFailed) {
+    // Position is still open and needs a new TP.
+    order.status = OrderStatus::kFilledOpenImmediate;
+    DEBUG("TP order rejected, tp_price: " << order.tp_price);
+    return false;
+  } else {
+    order.status = OrderStatus::kFilledCloseWait;
+    SeedOrderState(order.tpId, OrderStatus::kNew);
+  }
+  DEBUG("Synced TP order, tp_price: " << order.tp_price
+                                      << ", tpId: " << order.tpId
+                                      << ", status: " << order.status);
+  return true;
+}
+
+void Strategy::PlanLongTpOrders() {
+  int num = params_.tp_levels;
   for (int i = 0; i < num; ++i) {
     if (long_pos_.positionAmt - long_reduce_size_ < grid_size_) {
       IncreaseLongPosition();
@@ -788,56 +1147,38 @@ void Strategy::MakeLongTpOrders() {
       break;
     }
 
-    float tp_price = current_fix_long_price_ + order_interval_ * (i + num);
-    auto tp_price_str =
-        adjustDecimalPlaces(tp_price - order_interval_, order_price_round_);
+    int64_t tp_tick = current_fix_long_tick_ + num + i;
+    float tp_price = TickPrice(tp_tick);
+    // Levels are keyed by the place price one interval inside the TP.
+    int64_t level_tick = tp_tick - 1;
 
-    bool tp_order_exists = std::any_of(
-        unfilled_orders_.begin(), unfilled_orders_.end(),
-        [&](const auto& order) {
-          return order.is_reduce_only && order.positionSide == "LONG" &&
-                 areFloatsEqual(order.price, tp_price, PRICE_ACCURACY_FLOAT);
-        });
+    bool tp_order_exists =
+        open_orders_.contains(PositionSide::kLong, true, tp_tick);
 
     if (tp_order_exists) {
       continue;
     }
 
-    Order order;
-    order.side = "SELL";
-    order.positionSide = "LONG";
-    order.type = "LIMIT";
-    order.tp_price = tp_price;
-    order.size = grid_size_;
-
-    auto it = long_grid_order_list_.find(tp_price_str);
-    DEBUG("TRADE Placing long tp order at price: "
-          << tp_price << ", key: " << tp_price_str
+    standx::DesiredOrder desired;
+    desired.order.side = OrderSide::kSell;
+    desired.order.positionSide = PositionSide::kLong;
+    desired.order.type = OrderType::kLimit;
+    desired.order.tp_price = tp_price;
+    desired.order.size = grid_size_;
+    desired.order.is_reduce_only = true;
+    desired.tick = tp_tick;
+    desired.level_tick = level_tick;
+    desired.intent = standx::GridIntent::kCover;
+    DEBUG("TRADE Planning long tp order at price: "
+          << tp_price << ", tick: " << level_tick
           << ", current_price_: " << current_price_);
-    if (client_->tpOrder(order)) {
-      SyncTpOrderId(order);
-      long_reduce_size_ += grid_size_;
-      if (it != long_grid_order_list_.end()) {
-        it->second.tpId = order.tpId;
-        DEBUG("Update place long tpId for price: " << tp_price_str
-                                                   << ", tpId: " << order.tpId);
-      } else {
-        long_grid_order_list_[tp_price_str] = order;
-        DEBUG("Update insert long tpId for price: "
-              << tp_price_str << ", tpId: " << order.tpId);
-      }
-
-      NOTICE("TRADE Place TP order: " << order.contract << " " << order.tpId
-                                      << " " << tp_price_str << " "
-                                      << order.tp_price);
-    } else {
-      ERROR("Failed to place long TP order");
-    }
+    reconciler_.want(desired);
+    long_reduce_size_ += grid_size_;
   }
 }
 
-void Strategy::MakeShortTpOrders() {
-  int num = 5;
+void Strategy::PlanShortTpOrders() {
+  int num = params_.tp_levels;
   for (int i = 0; i < num; ++i) {
     if (fabs(short_pos_.positionAmt) - short_reduce_size_ < grid_size_) {
       IncreaseShortPosition();
@@ -845,80 +1186,63 @@ void Strategy::MakeShortTpOrders() {
       break;
     }
 
-    float tp_price = current_fix_short_price_ - order_interval_ * (i + num);
-    auto tp_price_str =
-        adjustDecimalPlaces(tp_price + order_interval_, order_price_round_);
+    int64_t tp_tick = current_fix_long_tick_ + 1 - num - i;
+    float tp_price = TickPrice(tp_tick);
+    // Levels are keyed by the place price one interval inside the TP.
+    int64_t level_tick = tp_tick + 1;
 
-    bool tp_order_exists = std::any_of(
-        unfilled_orders_.begin(), unfilled_orders_.end(),
-        [&](const auto& order) {
-          return order.is_reduce_only && order.positionSide == "SHORT" &&
-                 areFloatsEqual(order.price, tp_price, PRICE_ACCURACY_FLOAT);
-        });
+    bool tp_order_exists =
+        open_orders_.contains(PositionSide::kShort, true, tp_tick);
 
     if (tp_order_exists) {
       continue;
     }
 
-    Order order;
-    order.side = "BUY";
-    order.positionSide = "SHORT";
-    order.type = "LIMIT";
-    order.tp_price = tp_price;
-    order.size = grid_size_;
-
-    auto it = short_grid_order_list_.find(tp_price_str);
-    DEBUG("TRADE Placing short tp order at price: "
-          << tp_price << ", key: " << tp_price_str
+    standx::DesiredOrder desired;
+    desired.order.side = OrderSide::kBuy;
+    desired.order.positionSide = PositionSide::kShort;
+    desired.order.type = OrderType::kLimit;
+    desired.order.tp_price = tp_price;
+    desired.order.size = grid_size_;
+    desired.order.is_reduce_only = true;
+    desired.tick = tp_tick;
+    desired.level_tick = level_tick;
+    desired.intent = standx::GridIntent::kCover;
+    DEBUG("TRADE Planning short tp order at price: "
+          << tp_price << ", tick: " << level_tick
           << ", current_price_: " << current_price_);
-    if (client_->tpOrder(order)) {
-      SyncTpOrderId(order);
-      short_reduce_size_ += grid_size_;
-      if (it != short_grid_order_list_.end()) {
-        it->second.tpId = order.tpId;
-        DEBUG("Update place short tpId for price: "
-              << tp_price_str << ", tpId: " << order.tpId);
-      } else {
-        short_grid_order_list_[tp_price_str] = order;
-        DEBUG("Update insert short tpId for price: "
-              << tp_price_str << ", tpId: " << order.tpId);
-      }
-
-      NOTICE("TRADE Place TP order: " << order.contract << " " << order.tpId
-                                      << ", size: " << order.size
-                                      << ", price: " << order.tp_price);
-    } else {
-      ERROR("Failed to place short TP order");
-    }
+    reconciler_.want(desired);
+    short_reduce_size_ += grid_size_;
   }
 }
 
 void Strategy::IncreaseLongPosition() {
-  if (long_pos_.positionAmt < grid_size_ * ORDER_NUM * MAX_ORDER_NUM_FACTOR) {
+  if (long_pos_.positionAmt <
+      grid_size_ * params_.order_num * params_.max_order_num_factor) {
     Order order;
-    order.side = "BUY";
-    order.positionSide = "LONG";
-    order.type = "MARKET";
+    order.side = OrderSide::kBuy;
+    order.positionSide = PositionSide::kLong;
+    order.type = OrderType::kMarket;
     order.price = 0;
-    order.size = grid_size_ * ORDER_NUM;
+    order.size = grid_size_ * params_.order_num;
     client_->placeOrder(order);
     NOTICE("Increase long position at " << current_price_);
-    SLEEP_MS(1000);
+    client_->sleep(1000);
   }
 }
 
 void Strategy::IncreaseShortPosition() {
   if (fabs(short_pos_.positionAmt) <
-      grid_size_ * ORDER_NUM * MAX_ORDER_NUM_FACTOR) {
+      grid_size_ * params_.order_num * params_.max_order_num_factor) {
     Order order;
-    order.side = "SELL";
-    order.positionSide = "SHORT";
-    order.type = "MARKET";
+    order.side = OrderSide::kSell;
+    order.positionSide = PositionSide::kShort;
+    order.type = OrderType::kMarket;
     order.price = 0;
-    order.size = grid_size_ * ORDER_NUM;
+    order.size = grid_size_ * params_.order_num;
     client_->placeOrder(order);
     NOTICE("Increase short position at " << current_price_);
-    SLEEP_MS(1000);
+    client_->sleep(1000);
   }
 }
 
@@ -1,32 +1,59 @@
 #ifndef _STRATEGY_H
 #define _STRATEGY_H
 
-#include <list>
-#include <map>
+#include <atomic>
+#include <cmath>
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include "Poco/Runnable.h"
 #include "Poco/Thread.h"
 #include "Poco/Timestamp.h"
 #include "data.h"
+#include "event_queue.h"
+#include "exchange.h"
+#include "grid_ladder.h"
+#include "grid_reconciler.h"
+#include "market_data.h"
+#include "order_book.h"
+#include "order_stream.h"
 #include "standx_client.h"
 #include "tracer.h"
 
+using standx::MarketDataFeed;
+using standx::OrderEventStream;
 using standx::StandXClient;
 
 class Strategy : public Poco::Runnable {
  public:
-  Strategy(std::shared_ptr<StandXClient> client);
+  // wait_strategy decides how run() sleeps between steps; null takes
+  // strategy.waitStrategy from the config. Without params the grid uses
+  // DefaultParams for the client's symbol.
+  Strategy(std::shared_ptr<standx::Exchange> client,
+           std::unique_ptr<standx::WaitStrategy> wait_strategy = nullptr,
+           std::optional<GridParams> params = std::nullopt);
+
+  // Per-symbol grid defaults, sized from the config.
+  static GridParams DefaultParams(const std::string &inst_id);
 
   virtual ~Strategy();
   void run() override;
 
   void start();
   void stop();
+  // One pass of the loop: refresh price and position, then reconcile the
+  // grid. run() calls it on the strategy's own thread; StrategyHost calls
+  // it from a shared worker instead of starting the thread.
+  void Step();
+  standx::EventQueue &events() { return *events_; }
   bool isRunning() { return thread_->isRunning(); }
   std::string GetInstId() { return instId_; }
   void Init();
+  // Both register wake-up listeners, so call them before starting the feed
+  // or stream.
+  void SetMarketDataFeed(std::shared_ptr<MarketDataFeed> feed);
+  void SetOrderEventStream(std::shared_ptr<OrderEventStream> stream);
 
  private:
   bool UpdatePosition();
@@ -35,28 +62,55 @@ class Strategy : public Poco::Runnable {
   bool CheckUnfilledOrders();
   void CheckFilledLongOrders();
   void CheckFilledShortOrders();
+  bool CheckLongPlaceFill(int64_t tick);
+  bool CheckLongTpFill(int64_t tick);
+  bool CheckShortPlaceFill(int64_t tick);
+  bool CheckShortTpFill(int64_t tick);
   void RunLongGrid();
   void RunShortGrid();
-  void DeleteLongTpOrders();
-  void DeleteLongPlaceOrders();
-  void DeleteShortTpOrders();
-  void DeleteShortPlaceOrders();
   void CountLongReduceSize();
   void CountShortReduceSize();
   void InitLongPlaceOrders();
   void InitShortPlaceOrders();
   void InitLongTpOrders();
   void InitShortTpOrders();
-  void MakeLongPlaceOrders();
-  void MakeShortPlaceOrders();
-  void MakeLongTpOrders();
-  void MakeShortTpOrders();
+  void PlanLongPlaceOrders();
+  void PlanShortPlaceOrders();
+  void PlanLongTpOrders();
+  void PlanShortTpOrders();
+  void WantTakeProfit(int64_t level_tick, const Order &level,
+                      PositionSide position_side, float tp_price,
+                      int64_t replaces);
+  void DispatchGridActions(const standx::GridActions &actions);
+  // resolved is the placement's exchange id and state, id 0 if unknown.
+  void ApplyPlaced(standx::DesiredOrder &desired, bool ok,
+                   const Order &resolved);
+  void ReleaseLevel(const Order &order);
+  standx::GridLadder<Order> &Ladder(PositionSide side) {
+    return side == PositionSide::kShort ? short_grid_ladder_
+                                        : long_grid_ladder_;
+  }
   void InitParameters();
   void IncreaseLongPosition();
   void IncreaseShortPosition();
   void ResetDailyCounters();
-  void SyncPlacedOrderId(Order &order);
-  void SyncTpOrderId(Order &order);
+  void OnPrice(double last);
+  void SyncPlacedOrderId(Order &order, const Order &resolved);
+  bool SyncTpOrderId(Order &order, const Order &resolved);
+  int64_t PriceTick(float price) const {
+    return std::llround(price / order_interval_);
+  }
+  float TickPrice(int64_t tick) const { return tick * order_interval_; }
+  // One look at the stream table, then one REST probe.
+  bool LookupClientOrder(const ClientOrderId &cl_ord_id, Order &out);
+  // Looks up the accepted placements of one dispatch, resolved[i] for
+  // placing[i]: from the stream while it is up, then with concurrent REST
+  // probes. resolved[i].id stays 0 for one not visible yet.
+  void ResolvePlacedOrders(const std::vector<standx::DesiredOrder> &placing,
+                           const std::vector<bool> &placed,
+                           std::vector<Order> &resolved);
+  bool QueryOrderStatus(Order &order);
+  void SeedOrderState(int64_t id, OrderStatus status);
 
  private:
   bool thread_running_{false};
@@ -65,27 +119,41 @@ class Strategy : public Poco::Runnable {
 
   std::string instId_;
   std::shared_ptr<Poco::Thread> thread_;
-  std::shared_ptr<StandXClient> client_;
+  std::shared_ptr<standx::Exchange> client_;
+  std::shared_ptr<MarketDataFeed> feed_;
+  std::shared_ptr<OrderEventStream> order_stream_;
+  std::unique_ptr<standx::EventQueue> events_;
+  // Grid level of the last streamed price that woke the loop.
+  std::atomic<int64_t> price_level_{INT64_MIN};
 
   Position long_pos_;
   Position short_pos_;
 
   float base_price_{0.0};
   float current_price_{0.0};
+  int64_t price_ns_{0};  // monoNowNs() when current_price_ was received
+  float journal_price_{0.0};  // last price written to the journal
   float current_fix_long_price_{0.0};
   float current_fix_short_price_{0.0};
+  int64_t current_fix_long_tick_{0};
   float order_interval_{0.0};
-  float grid_size_{0.1};
+  GridParams params_;
+  Fixed grid_size_{0.1};
   int success_trades_total_{0};
   int success_trades_daily_{0};
   int last_reset_success_trades_day_{0};
-  std::string order_price_round_;
 
   float long_reduce_size_{0.0};
   float short_reduce_size_{0.0};
-  std::list<Order> unfilled_orders_;
-  std::map<std::string, Order> long_grid_order_list_;
-  std::map<std::string, Order> short_grid_order_list_;
+  standx::OrderBook open_orders_;
+  // Reused buffer for the open-orders poll.
+  std::vector<Order> open_orders_snapshot_;
+  standx::GridReconciler reconciler_;
+  // Grid levels keyed by price tick (see PriceTick), centered on the
+  // current fixed long price. Levels still holding an order or position
+  // when the price leaves them move to the ladders' overflow.
+  standx::GridLadder<Order> long_grid_ladder_;
+  standx::GridLadder<Order> short_grid_ladder_;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include "strategy_host.h"
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <thread>
+
+#include "event_queue.h"
+#include "tracer.h"
+
+// Forwards a strategy's wake-ups to the host's ready queue. wait() still
+// works, so a hosted strategy started on its own thread behaves as usual.
+class StrategyHost::HostWaitStrategy : public standx::WaitStrategy {
+ public:
+  HostWaitStrategy(StrategyHost *host, size_t index)
+      : host_(host), index_(index) {}
+
+  void wait(const std::atomic<uint32_t> &pending,
+            std::chrono::steady_clock::time_point deadline) override {
+    inner_.wait(pending, deadline);
+  }
+
+  void notify() override {
+    inner_.notify();
+    host_->Schedule(index_);
+  }
+
+  const char *name() const override { return "host"; }
+
+ private:
+  StrategyHost *host_;
+  size_t index_;
+  standx::BlockingWaitStrategy inner_;
+};
+
+std::vector<std::string> StrategyHost::ParseSymbols(const std::string &list) {
+  std::vector<std::string> symbols;
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    item.erase(std::remove_if(item.begin(), item.end(),
+                              [](unsigned char c) { return std::isspace(c); }),
+               item.end());
+    if (!item.empty() &&
+        std::find(symbols.begin(), symbols.end(), item) == symbols.end()) {
+      symbols.push_back(item);
+    }
+  }
+  return symbols;
+}
+
+StrategyHost::StrategyHost(std::shared_ptr<standx::Session> session,
+                           const std::vector<std::string> &symbols,
+                           int workers)
+    : tick_(kConfig.strategyTickIntervalMs), session_(session) {
+  size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+  workers_ = workers > 0 ? static_cast<size_t>(workers)
+                         : std::min(std::max<size_t>(symbols.size(), 1),
+                                    hardware);
+
+  slots_.reserve(symbols.size());
+  for (const auto &symbol : symbols) {
+    auto client = std::make_shared<StandXClient>(session_, symbol);
+    auto slot = std::make_unique<Slot>();
+    slot->strategy = std::make_shared<Strategy>(
+        client, std::make_unique<HostWaitStrategy>(this, slots_.size()));
+    slots_.push_back(std::move(slot));
+    NOTICE("Strategy host add " << symbol);
+  }
+}
+
+StrategyHost::~StrategyHost() { stop(); }
+
+void StrategyHost::SetMarketDataFeed(std::shared_ptr<MarketDataFeed> feed) {
+  for (auto &slot : slots_) slot->strategy->SetMarketDataFeed(feed);
+}
+
+void StrategyHost::SetOrderEventStream(
+    std::shared_ptr<OrderEventStream> stream) {
+  for (auto &slot : slots_) slot->strategy->SetOrderEventStream(stream);
+}
+
+void StrategyHost::start() {
+  if (running_) return;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = true;
+    next_tick_ = std::chrono::steady_clock::now();
+  }
+  for (size_t i = 0; i < workers_; ++i) {
+    threads_.push_back(std::make_unique<Poco::Thread>());
+    threads_.back()->setName("grid" + std::to_string(i));
+    threads_.back()->start(*this);
+  }
+  INFO("Strategy host start, symbols: " << slots_.size()
+                                        << ", workers: " << workers_);
+}
+
+void StrategyHost::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  cond_.notify_all();
+  for (auto &thread : threads_) thread->join();
+  threads_.clear();
+}
+
+void StrategyHost::Schedule(size_t index) {
+  if (!running_) return;
+  Slot &slot = *slots_[index];
+  if (slot.scheduled.exchange(true)) return;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ready_.push_back(index);
+  }
+  cond_.notify_one();
+}
+
+void StrategyHost::RunSlot(size_t index) {
+  Slot &slot = *slots_[index];
+  Strategy &strategy = *slot.strategy;
+  uint32_t events = strategy.events().poll();
+  if (!(events & standx::kEventShutdown)) {
+    try {
+      strategy.Step();
+    } catch (const std::exception &e) {
+      ERROR("Strategy step failed " << strategy.GetInstId() << ": "
+                                    << e.what());
+    }
+  }
+
+  // Events posted while the step ran found the slot still scheduled and
+  // were not queued; requeue behind the others instead of looping.
+  slot.scheduled.store(false);
+  if (strategy.events().has_pending()) Schedule(index);
+}
+
+void StrategyHost::run() {
+  int worker = next_worker_.fetch_add(1);
+  if (kConfig.strategyCpu >= 0 &&
+      !standx::pinCurrentThread(kConfig.strategyCpu + worker)) {
+    WARNING("Failed to pin strategy worker " << worker << " to cpu "
+                                             << kConfig.strategyCpu + worker);
+  }
+
+  while (running_) {
+    size_t index = 0;
+    bool timer = false;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cond_.wait_until(lock, next_tick_,
+                       [this]() { return !running_ || !ready_.empty(); });
+      if (!running_) break;
+      auto now = std::chrono::steady_clock::now();
+      if (now >= next_tick_) {
+        // One worker fires the shared timer for every strategy; it goes
+        // first so a busy ready queue cannot starve the quiet symbols.
+        next_tick_ += tick_;
+        if (next_tick_ <= now) next_tick_ = now + tick_;
+        timer = true;
+      } else if (!ready_.empty()) {
+        index = ready_.front();
+        ready_.pop_front();
+      } else {
+        continue;
+      }
+    }
+
+    if (timer) {
+      for (auto &slot : slots_) {
+        slot->strategy->events().post(standx::kEventTimer);
+      }
+      continue;
+    }
+    RunSlot(index);
+  }
+}
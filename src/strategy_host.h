@@ -0,0 +1,74 @@
+#ifndef _STRATEGY_HOST_H
+#define _STRATEGY_HOST_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include "market_data.h"
+#include "order_stream.h"
+#include "session.h"
+#include "strategy.h"
+
+// Runs one Strategy per whitelisted symbol on a fixed pool of worker
+// threads. All strategies share one Session (login, HTTP engines), one
+// market data feed and one order stream.
+//
+// Strategies are not started; their event queues feed a shared ready queue
+// instead. A strategy is queued at most once, so it never runs on two
+// workers at the same time, and any worker may pick it up next.
+class StrategyHost : public Poco::Runnable {
+ public:
+  // Comma separated symbol list, blanks and empty entries dropped.
+  static std::vector<std::string> ParseSymbols(const std::string &list);
+
+  // workers <= 0 means one per symbol, capped at the hardware threads.
+  StrategyHost(std::shared_ptr<standx::Session> session,
+               const std::vector<std::string> &symbols, int workers);
+  ~StrategyHost();
+
+  // Feed and stream listeners are registered here, so call both before
+  // starting the feed or stream.
+  void SetMarketDataFeed(std::shared_ptr<MarketDataFeed> feed);
+  void SetOrderEventStream(std::shared_ptr<OrderEventStream> stream);
+
+  void start();
+  void stop();
+
+  size_t size() const { return slots_.size(); }
+
+  // Worker loop.
+  void run() override;
+
+ private:
+  class HostWaitStrategy;
+
+  struct Slot {
+    std::shared_ptr<Strategy> strategy;
+    std::atomic<bool> scheduled{false};
+  };
+
+  void Schedule(size_t index);
+  void RunSlot(size_t index);
+
+  std::atomic<bool> running_{false};
+  size_t workers_{1};
+  std::atomic<int> next_worker_{0};
+  std::chrono::milliseconds tick_;
+  std::chrono::steady_clock::time_point next_tick_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::deque<size_t> ready_;
+  std::vector<std::unique_ptr<Poco::Thread>> threads_;
+  std::shared_ptr<standx::Session> session_;
+  std::vector<std::unique_ptr<Slot>> slots_;
+};
+
+#endif
@@ -0,0 +1,125 @@
+#include "tick_file.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace standx {
+
+static_assert(sizeof(Tick) == kTickRecordSize,
+              "Tick must match the on-disk record layout");
+
+namespace {
+
+bool endsWith(const std::string& text, const std::string& suffix) {
+  return text.size() >= suffix.size() &&
+         text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+void decode(const char* in, Tick& tick) {
+  uint64_t price_bits = getLE(in + 8);
+  tick.ts_ms = static_cast<int64_t>(getLE(in));
+  std::memcpy(&tick.price, &price_bits, sizeof(tick.price));
+}
+
+bool checkHeader(const char* header) {
+  return std::memcmp(header, kTickFileMagic, sizeof(kTickFileMagic)) == 0;
+}
+
+bool loadCsv(const std::string& path, std::vector<Tick>& ticks,
+             std::string& error) {
+  std::ifstream in(path);
+  if (!in) {
+    error = "cannot open " + path;
+    return false;
+  }
+  std::string line;
+  size_t line_no = 0;
+  while (std::getline(in, line)) {
+    ++line_no;
+    if (line.empty() || line[0] == '#') continue;
+    const char* begin = line.c_str();
+    char* end = nullptr;
+    long long ts = std::strtoll(begin, &end, 10);
+    if (end == begin || *end != ',') {
+      if (line_no == 1) continue;  // header
+      error = path + ":" + std::to_string(line_no) + ": expected ts_ms,price";
+      return false;
+    }
+    const char* price_begin = end + 1;
+    double price = std::strtod(price_begin, &end);
+    if (end == price_begin || price <= 0) {
+      error = path + ":" + std::to_string(line_no) + ": bad price";
+      return false;
+    }
+    ticks.push_back(Tick{static_cast<int64_t>(ts), price});
+  }
+  return true;
+}
+
+bool loadBinary(const std::string& path, std::vector<Tick>& ticks,
+                std::string& error) {
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in) {
+    error = "cannot open " + path;
+    return false;
+  }
+  std::streamoff size = in.tellg();
+  in.seekg(0);
+  char magic[sizeof(kTickFileMagic)];
+  if (size < static_cast<std::streamoff>(sizeof(magic)) ||
+      !in.read(magic, sizeof(magic)) || !checkHeader(magic)) {
+    error = path + ": not a tick file";
+    return false;
+  }
+  size_t count = static_cast<size_t>(size - sizeof(magic)) / kTickRecordSize;
+  ticks.reserve(ticks.size() + count);
+
+  char record[kTickRecordSize];
+  for (size_t i = 0; i < count && in.read(record, sizeof(record)); ++i) {
+    Tick tick;
+    decode(record, tick);
+    ticks.push_back(tick);
+  }
+  return true;
+}
+
+}  // namespace
+
+bool loadTicks(const std::string& path, std::vector<Tick>& ticks,
+               std::string& error) {
+  ticks.clear();
+  return endsWith(path, ".csv") ? loadCsv(path, ticks, error)
+                                : loadBinary(path, ticks, error);
+}
+
+bool saveTicks(const std::string& path, const std::vector<Tick>& ticks,
+               std::string& error) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    error = "cannot create " + path;
+    return false;
+  }
+  out.write(kTickFileMagic, sizeof(kTickFileMagic));
+  char record[kTickRecordSize];
+  for (const auto& tick : ticks) {
+    uint64_t price_bits;
+    std::memcpy(&price_bits, &tick.price, sizeof(price_bits));
+    putLE(static_cast<uint64_t>(tick.ts_ms), record);
+    putLE(price_bits, record + 8);
+    out.write(record, sizeof(record));
+  }
+  if (!out) {
+    error = "write failed: " + path;
+    return false;
+  }
+  return true;
+}
+
+bool MappedTicks::open(const std::string& path, std::string& error) {
+  // The 8-byte magic keeps records 8-byte aligned in the page-aligned map.
+  return records_.open(path, sizeof(kTickFileMagic), checkHeader, decode,
+                       "tick file", error);
+}
+
+}  // namespace standx
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mapped_file.h"
+
+namespace standx {
+
+// One recorded trade price.
+struct Tick {
+    int64_t ts_ms{0};  // exchange time, ms since epoch
+    double price{0.0};
+};
+
+// Binary tick file: the 8-byte magic "SXTICK1\0" followed by packed
+// little-endian {int64 ts_ms, double price} records, 16 bytes each.
+constexpr char kTickFileMagic[8] = {'S', 'X', 'T', 'I', 'C', 'K', '1', '\0'};
+constexpr size_t kTickRecordSize = 16;
+
+// Load ticks from path. Files ending in ".csv" are read as text lines of
+// "ts_ms,price" (a non-numeric header line is skipped); anything else must
+// be a binary tick file. Returns false with error set on failure.
+bool loadTicks(const std::string& path, std::vector<Tick>& ticks,
+               std::string& error);
+
+// Write ticks as a binary tick file.
+bool saveTicks(const std::string& path, const std::vector<Tick>& ticks,
+               std::string& error);
+
+// Read-only memory mapping of a binary tick file. On little-endian hosts
+// the records are used in place, so any number of readers (sweep workers)
+// share one copy of the data through the page cache.
+class MappedTicks {
+public:
+    bool open(const std::string& path, std::string& error);
+
+    const Tick* data() const { return records_.data(); }
+    size_t size() const { return records_.size(); }
+
+private:
+    MappedRecords<Tick> records_;
+};
+
+}  // namespace standx
@@ -108,4 +108,21 @@ int Tracer::GetLevel(const std::string &name) {
   return Poco::Logger::get(name).getLevel();
 }
 
+void Tracer::StartAsync(size_t ring_bytes, OverflowPolicy policy) {
+  AsyncLogger::instance().Start(ring_bytes, policy);
+}
+
+void Tracer::StopAsync() { AsyncLogger::instance().Stop(); }
+
+void Tracer::Write(Poco::Logger &logger, int level, const char *file,
+                   int line, const char *text, size_t size) {
+  AsyncLogger &async = AsyncLogger::instance();
+  if (async.running() && async.Push(&logger, level, file, line, text, size)) {
+    return;
+  }
+  Message msg(logger.name(), std::string(text, size),
+              static_cast<Message::Priority>(level), file, line);
+  logger.log(msg);
+}
+
 }  // namespace logger
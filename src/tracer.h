@@ -10,6 +10,7 @@
 #ifndef _TRACER_H
 #define _TRACER_H
 
+#include <atomic>
 #include <cstdio>
 #include <sstream>
 #include <string>
@@ -24,9 +25,19 @@
 #include "Poco/Message.h"
 #include "Poco/PatternFormatter.h"
 #include "Poco/SimpleFileChannel.h"
+#include "async_logger.h"
 
 const std::string DEFAULT_LOGGER_NAME = "default";
 
+// Least severe priority that is compiled in at all (Poco numbering, 1 fatal
+// ... 8 trace). Log calls below it are removed from the binary and cost
+// nothing; the logger level still filters the rest at run time.
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL 8
+#endif
+
+#define LOG_LEVEL_ENABLED(level) ((level) <= LOG_MIN_LEVEL)
+
 namespace logger {
 
 /*!
@@ -67,34 +78,75 @@ class Tracer {
 
   static int GetLevel(const std::string &name);
 
+  // Hand records to a background writer thread from now on; until then,
+  // and after StopAsync, the calling thread writes them itself.
+  static void StartAsync(size_t ring_bytes, OverflowPolicy policy);
+
+  static void StopAsync();
+
+  // Used by LOGMSG; file is a base name with static storage.
+  static void Write(Poco::Logger &logger, int level, const char *file,
+                    int line, const char *text, size_t size);
+
  private:
   static std::vector<std::string> logger_;
 };
 
+// Base name of a path, evaluated at compile time for __FILE__.
+constexpr const char *BaseName(const char *path) {
+  const char *base = path;
+  for (; *path != '\0'; ++path) {
+    if (*path == '/') base = path + 1;
+  }
+  return base;
+}
+
+/*!
+ * @class logger.LoggerHandle
+ * @brief caches a Poco::Logger at one call site, so only the first log call
+ *        there takes the logger registry lock. Until the logger is created
+ *        every call looks it up again.
+ */
+class LoggerHandle {
+ public:
+  explicit LoggerHandle(const std::string &name) : name_(name) {}
+
+  Poco::Logger *get() {
+    Poco::Logger *logger = logger_.load(std::memory_order_acquire);
+    if (logger == nullptr) {
+      logger = Poco::Logger::has(name_);
+      if (logger != nullptr) logger_.store(logger, std::memory_order_release);
+    }
+    return logger;
+  }
+
+ private:
+  const std::string name_;
+  std::atomic<Poco::Logger *> logger_{nullptr};
+};
+
 }  // namespace logger
 
-#define LOGMSG(logger_name, message, level)                                   \
-  do {                                                                        \
-    try {                                                                     \
-      if (Poco::Logger::has(logger_name)) {                                   \
-        auto &logger = Poco::Logger::get(logger_name);                        \
-        if (logger.getLevel() >= level) {                                     \
-          std::stringstream ss;                                               \
-          ss << message;                                                      \
-          std::string filePath{__FILE__};                                     \
-          size_t pos = filePath.find_last_of("/");                            \
-          filePath = (pos == std::string::npos) ? filePath                    \
-                                                : filePath.substr(pos + 1);   \
-          Poco::Message msg(logger.name(), ss.str(), level, filePath.c_str(), \
-                            __LINE__);                                        \
-          logger.log(msg);                                                    \
-        }                                                                     \
-      } else {                                                                \
-        perror("ERROR:logger should init before user\n");                     \
-      }                                                                       \
-    } catch (const Poco::Exception &e) {                                      \
-      perror(e.what());                                                       \
-    }                                                                         \
+// logger_name must be the same at every pass through one call site.
+#define LOGMSG(logger_name, message, level)                               \
+  do {                                                                    \
+    if constexpr (LOG_LEVEL_ENABLED(level)) {                             \
+      try {                                                               \
+        static logger::LoggerHandle log_handle(logger_name);              \
+        Poco::Logger *log_target = log_handle.get();                      \
+        if (log_target == nullptr) {                                      \
+          perror("ERROR:logger should init before user\n");               \
+        } else if (log_target->getLevel() >= level) {                     \
+          constexpr const char *log_file = logger::BaseName(__FILE__);    \
+          logger::LogLine log_line;                                       \
+          log_line.stream() << message;                                   \
+          logger::Tracer::Write(*log_target, level, log_file, __LINE__,   \
+                                log_line.data(), log_line.size());        \
+        }                                                                 \
+      } catch (const Poco::Exception &e) {                                \
+        perror(e.what());                                                 \
+      }                                                                   \
+    }                                                                     \
   } while (0);
 
 #define TRACE_(logger_name, message) \
@@ -0,0 +1,184 @@
+#include "ws_client.h"
+
+#include <algorithm>
+
+#include "Poco/Exception.h"
+#include "Poco/Net/Context.h"
+#include "Poco/Net/HTTPClientSession.h"
+#include "Poco/Net/HTTPRequest.h"
+#include "Poco/Net/HTTPResponse.h"
+#include "Poco/Net/HTTPSClientSession.h"
+#include "Poco/Net/WebSocket.h"
+#include "Poco/URI.h"
+#include "data.h"
+#include "tracer.h"
+#include "util.h"
+
+using Poco::Net::WebSocket;
+
+namespace standx {
+
+namespace {
+
+const int kReceiveTimeoutSec = 30;
+const long kMinBackoffMs = 500;
+const long kMaxBackoffMs = 10000;
+const int kFrameBufferSize = 1 << 16;
+
+// Verifies the server against ws.caLocation (a CA file or directory) when
+// set, and against the system trust store otherwise.
+Poco::Net::Context::Ptr sslContext() {
+  static std::once_flag once;
+  static Poco::Net::Context::Ptr context;
+  std::call_once(once, []() {
+    Poco::Net::initializeSSL();
+    const std::string& ca_location = kConfig.wsCaLocation;
+    context = new Poco::Net::Context(Poco::Net::Context::TLS_CLIENT_USE,
+                                     ca_location,
+                                     Poco::Net::Context::VERIFY_RELAXED, 9,
+                                     ca_location.empty());
+  });
+  return context;
+}
+
+}  // namespace
+
+WsClient::WsClient(const std::string& name, const std::string& url)
+    : name_(name), url_(url), thread_(name) {}
+
+WsClient::~WsClient() { stop(); }
+
+void WsClient::start() {
+  if (running_.exchange(true)) return;
+  thread_.start(*this);
+}
+
+void WsClient::stop() {
+  if (!running_.exchange(false)) return;
+  {
+    std::lock_guard<std::mutex> lock(send_mutex_);
+    if (ws_) {
+      try {
+        ws_->shutdown();
+      } catch (const Poco::Exception&) {
+      }
+    }
+  }
+  thread_.join();
+}
+
+bool WsClient::send(const std::string& text) {
+  std::lock_guard<std::mutex> lock(send_mutex_);
+  if (!ws_ || !connected_) return false;
+  try {
+    ws_->sendFrame(text.data(), (int)text.size(), WebSocket::FRAME_TEXT);
+    return true;
+  } catch (const Poco::Exception& e) {
+    ERROR("ws " << name_ << " send failed: " << e.displayText());
+    return false;
+  }
+}
+
+void WsClient::run() {
+  INFO("ws " << name_ << " start: " << url_);
+  long backoff_ms = kMinBackoffMs;
+  while (running_) {
+    try {
+      session();
+      backoff_ms = kMinBackoffMs;
+    } catch (const Poco::Exception& e) {
+      // Before connected_ is set the failure is the TLS or upgrade
+      // handshake, e.g. an untrusted certificate.
+      ERROR("ws " << name_
+                  << (connected_ ? " error: " : " handshake failed: ")
+                  << e.displayText());
+    } catch (const std::exception& e) {
+      ERROR("ws " << name_
+                  << (connected_ ? " error: " : " handshake failed: ")
+                  << e.what());
+    }
+
+    bool was_connected = connected_.exchange(false);
+    {
+      std::lock_guard<std::mutex> lock(send_mutex_);
+      ws_.reset();
+      http_session_.reset();
+    }
+    if (was_connected && on_close_) on_close_();
+
+    if (!running_) break;
+    WARNING("ws " << name_ << " reconnect in " << backoff_ms << " ms");
+    SLEEP_MS(backoff_ms);
+    backoff_ms = std::min(backoff_ms * 2, kMaxBackoffMs);
+  }
+  INFO("ws " << name_ << " stop");
+}
+
+void WsClient::session() {
+  Poco::URI uri(url_);
+  std::unique_ptr<Poco::Net::HTTPClientSession> http;
+  if (uri.getScheme() == "wss") {
+    http = std::make_unique<Poco::Net::HTTPSClientSession>(
+        uri.getHost(), uri.getPort(), sslContext());
+  } else {
+    http = std::make_unique<Poco::Net::HTTPClientSession>(uri.getHost(),
+                                                          uri.getPort());
+  }
+
+  Poco::Net::HTTPRequest request(Poco::Net::HTTPRequest::HTTP_GET,
+                                 uri.getPathAndQuery(),
+                                 Poco::Net::HTTPRequest::HTTP_1_1);
+  Poco::Net::HTTPResponse response;
+  auto ws = std::make_unique<WebSocket>(*http, request, response);
+  ws->setReceiveTimeout(Poco::Timespan(kReceiveTimeoutSec, 0));
+
+  {
+    std::lock_guard<std::mutex> lock(send_mutex_);
+    http_session_ = std::move(http);
+    ws_ = std::move(ws);
+    connected_ = true;
+  }
+  NOTICE("ws " << name_ << " connected");
+
+  if (on_open_) {
+    for (const auto& frame : on_open_()) send(frame);
+  }
+
+  std::vector<char> buffer(kFrameBufferSize);
+  std::string message;
+  while (running_) {
+    int flags = 0;
+    int n = ws_->receiveFrame(buffer.data(), (int)buffer.size(), flags);
+    int opcode = flags & WebSocket::FRAME_OP_BITMASK;
+
+    if (n == 0 && flags == 0) {
+      WARNING("ws " << name_ << " closed by peer");
+      return;
+    }
+    if (opcode == static_cast<int>(WebSocket::FRAME_OP_CLOSE)) {
+      WARNING("ws " << name_ << " close frame received");
+      return;
+    }
+    if (opcode == static_cast<int>(WebSocket::FRAME_OP_PING)) {
+      std::lock_guard<std::mutex> lock(send_mutex_);
+      ws_->sendFrame(buffer.data(), n,
+                     WebSocket::FRAME_FLAG_FIN | WebSocket::FRAME_OP_PONG);
+      continue;
+    }
+    if (opcode == static_cast<int>(WebSocket::FRAME_OP_PONG)) continue;
+
+    message.append(buffer.data(), n);
+    if (!(flags & WebSocket::FRAME_FLAG_FIN)) continue;
+
+    if (on_message_) {
+      try {
+        on_message_(message);
+      } catch (const std::exception& e) {
+        ERROR("ws " << name_ << " message handler error: " << e.what());
+      }
+    }
+    message.clear();
+  }
+}
+
+}  // namespace standx
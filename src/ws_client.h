@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+
+namespace Poco {
+namespace Net {
+class WebSocket;
+class HTTPClientSession;
+}  // namespace Net
+}  // namespace Poco
+
+namespace standx {
+
+// Reconnecting WebSocket client. A dedicated thread connects, sends the
+// frames returned by the open callback (auth / subscribe) and hands every
+// text frame to the message callback. On any error it backs off and
+// reconnects, re-running the open callback; the close callback runs each
+// time a connection is lost.
+class WsClient : public Poco::Runnable {
+public:
+    using OpenCallback = std::function<std::vector<std::string>()>;
+    using MessageCallback = std::function<void(const std::string&)>;
+    using CloseCallback = std::function<void()>;
+
+    WsClient(const std::string& name, const std::string& url);
+    ~WsClient();
+
+    void set_open_callback(OpenCallback callback) { on_open_ = callback; }
+    void set_message_callback(MessageCallback callback) { on_message_ = callback; }
+    void set_close_callback(CloseCallback callback) { on_close_ = callback; }
+
+    void start();
+    void stop();
+
+    bool is_connected() const { return connected_.load(std::memory_order_acquire); }
+
+    // Send a text frame on the current connection, false when disconnected.
+    bool send(const std::string& text);
+
+    void run() override;
+
+private:
+    void session();
+
+    std::string name_;
+    std::string url_;
+    OpenCallback on_open_;
+    MessageCallback on_message_;
+    CloseCallback on_close_;
+
+    std::atomic<bool> running_{false};
+    std::atomic<bool> connected_{false};
+    Poco::Thread thread_;
+
+    std::mutex send_mutex_;
+    std::unique_ptr<Poco::Net::HTTPClientSession> http_session_;
+    std::unique_ptr<Poco::Net::WebSocket> ws_;
+};
+
+}  // namespace standx
@@ -0,0 +1,262 @@
+// Round-trip checks and a micro-benchmark for the hex, base64 and base58
+// codecs.
+//
+//   standx_codec_bench [iterations]
+//
+// Compares the buffer codecs in crypto_utils with the previous stream and
+// push_back implementations (kept below as the reference) over random
+// inputs of every length up to 300 bytes, then times both on the sizes
+// the client encodes per request and at login. Exits non-zero on any
+// mismatch.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "crypto_utils.h"
+
+namespace {
+
+namespace reference {
+
+const char* kBase58Alphabet =
+    "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+
+std::string bytes_to_hex(const unsigned char* data, size_t len) {
+  std::ostringstream ss;
+  ss << std::hex << std::setfill('0');
+  for (size_t i = 0; i < len; ++i) {
+    ss << std::setw(2) << (int)data[i];
+  }
+  return ss.str();
+}
+
+std::string base58_encode(const unsigned char* bytes, size_t len) {
+  std::vector<unsigned char> input(bytes, bytes + len);
+  size_t zeros = 0;
+  while (zeros < input.size() && input[zeros] == 0) ++zeros;
+
+  std::vector<unsigned char> b58((input.size() - zeros) * 138 / 100 + 1);
+  size_t j = 0;
+  for (size_t i = zeros; i < input.size(); ++i) {
+    int carry = input[i];
+    size_t k = 0;
+    for (auto it = b58.rbegin(); (carry != 0 || k < j) && it != b58.rend();
+         ++it, ++k) {
+      carry += 256 * (*it);
+      *it = carry % 58;
+      carry /= 58;
+    }
+    j = k;
+  }
+
+  std::string result;
+  result.reserve(zeros + j);
+  for (size_t i = 0; i < zeros; ++i) result.push_back('1');
+  auto it = b58.begin();
+  while (it != b58.end() && *it == 0) ++it;
+  for (; it != b58.end(); ++it) result.push_back(kBase58Alphabet[*it]);
+  return result;
+}
+
+std::string base64_encode(const unsigned char* data, size_t len) {
+  static const char* b64chars =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string result;
+  result.reserve(((len + 2) / 3) * 4);
+
+  for (size_t i = 0; i < len; i += 3) {
+    unsigned int val = (data[i] << 16);
+    if (i + 1 < len) val |= (data[i + 1] << 8);
+    if (i + 2 < len) val |= data[i + 2];
+
+    result.push_back(b64chars[(val >> 18) & 0x3F]);
+    result.push_back(b64chars[(val >> 12) & 0x3F]);
+    result.push_back((i + 1 < len) ? b64chars[(val >> 6) & 0x3F] : '=');
+    result.push_back((i + 2 < len) ? b64chars[val & 0x3F] : '=');
+  }
+
+  return result;
+}
+
+std::string base64url_decode(const std::string& in) {
+  std::string s = in;
+  for (char& c : s) {
+    if (c == '-')
+      c = '+';
+    else if (c == '_')
+      c = '/';
+  }
+  while (s.size() % 4) s.push_back('=');
+
+  static const std::string B64 =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::vector<int> T(256, -1);
+  for (int i = 0; i < 64; ++i) T[(unsigned char)B64[i]] = i;
+
+  // unsigned: the int in the original overflowed on long inputs.
+  std::string out;
+  unsigned int val = 0;
+  int valb = -8;
+  for (unsigned char c : s) {
+    if (T[c] == -1) break;
+    val = (val << 6) + T[c];
+    valb += 6;
+    if (valb >= 0) {
+      out.push_back(char((val >> valb) & 0xFF));
+      valb -= 8;
+    }
+  }
+  return out;
+}
+
+}  // namespace reference
+
+int failures = 0;
+
+void expect(const std::string& what, const std::string& got,
+            const std::string& want) {
+  if (got == want) return;
+  if (++failures <= 10) {
+    printf("FAIL %s\n  got  %s\n  want %s\n", what.c_str(), got.c_str(),
+           want.c_str());
+  }
+}
+
+std::string toUrl(std::string text, bool strip_padding) {
+  for (auto& c : text) {
+    if (c == '+') c = '-';
+    if (c == '/') c = '_';
+  }
+  while (strip_padding && !text.empty() && text.back() == '=') text.pop_back();
+  return text;
+}
+
+void crossCheck() {
+  std::mt19937_64 rng(7);
+  std::vector<unsigned char> buffer(301);
+  std::vector<char> text(2 * buffer.size());
+  std::vector<unsigned char> decoded(buffer.size());
+
+  for (size_t len = 0; len <= 300; ++len) {
+    for (int round = 0; round < 4; ++round) {
+      for (auto& b : buffer) b = static_cast<unsigned char>(rng());
+      // Leading zero bytes become '1's in base58.
+      for (int z = 0; z < round && static_cast<size_t>(z) < len; ++z) {
+        buffer[1 + z] = 0;
+      }
+      const unsigned char* data = buffer.data() + 1;  // unaligned
+      std::string what = " of " + std::to_string(len) + " bytes";
+
+      std::string hex(text.data(), standx::hex_encode(data, len, text.data()));
+      expect("hex" + what, hex, reference::bytes_to_hex(data, len));
+      bool ok = standx::hex_decode(hex.data(), hex.size(), decoded.data());
+      expect("hex round trip" + what,
+             ok ? std::string(decoded.begin(), decoded.begin() + len) : "!",
+             std::string(data, data + len));
+
+      std::string b64(text.data(),
+                      standx::base64_encode(data, len, text.data()));
+      expect("base64" + what, b64, reference::base64_encode(data, len));
+      for (bool strip : {false, true}) {
+        std::string url = toUrl(b64, strip);
+        size_t n = standx::base64_decode(url.data(), url.size(),
+                                         decoded.data());
+        expect("base64url decode" + what,
+               std::string(decoded.begin(), decoded.begin() + n),
+               reference::base64url_decode(url));
+      }
+
+      std::string b58(text.data(),
+                      standx::base58_encode(data, len, text.data()));
+      expect("base58" + what, b58, reference::base58_encode(data, len));
+    }
+  }
+
+  // Decoding stops at the first character outside the alphabet.
+  std::string broken = "aGVsbG8gd29y!bGQ=";
+  expect("base64 invalid", standx::base64url_decode(broken),
+         reference::base64url_decode(broken));
+  unsigned char dummy[1];
+  if (standx::hex_decode("0g", 2, dummy)) expect("hex invalid", "ok", "!");
+}
+
+template <typename F>
+double nsPerCall(size_t calls, F&& f) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < calls; ++i) f();
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::nano>(elapsed).count() / calls;
+}
+
+void row(const char* name, size_t size, double ref, double fast) {
+  printf("%-16s %6zu %14.1f %14.1f %8.1fx\n", name, size, ref, fast,
+         ref / fast);
+}
+
+void benchmark(size_t iterations) {
+  std::vector<unsigned char> data(512);
+  std::mt19937_64 rng(1);
+  for (auto& b : data) b = static_cast<unsigned char>(rng());
+  char text[1024];
+  unsigned char bytes[512];
+  volatile size_t sink = 0;
+
+  printf("%-16s %6s %14s %14s %9s\n", "codec", "bytes", "reference ns",
+         "buffer ns", "speedup");
+
+  // 32: keys and hashes; 64/65: signatures.
+  for (size_t size : {32, 65, 256}) {
+    row("hex encode", size, nsPerCall(iterations, [&] {
+          sink += reference::bytes_to_hex(data.data(), size).size();
+        }),
+        nsPerCall(iterations,
+                  [&] { sink += standx::hex_encode(data.data(), size, text); }));
+  }
+  for (size_t size : {64, 65, 256}) {
+    row("base64 encode", size, nsPerCall(iterations, [&] {
+          sink += reference::base64_encode(data.data(), size).size();
+        }),
+        nsPerCall(iterations, [&] {
+          sink += standx::base64_encode(data.data(), size, text);
+        }));
+  }
+  // A JWT payload is a few hundred characters.
+  for (size_t size : {64, 300}) {
+    std::string encoded =
+        toUrl(reference::base64_encode(data.data(), size), true);
+    row("base64url decode", encoded.size(), nsPerCall(iterations, [&] {
+          sink += reference::base64url_decode(encoded).size();
+        }),
+        nsPerCall(iterations, [&] {
+          sink += standx::base64_decode(encoded.data(), encoded.size(), bytes);
+        }));
+  }
+  row("base58 encode", 32, nsPerCall(iterations, [&] {
+        sink += reference::base58_encode(data.data(), 32).size();
+      }),
+      nsPerCall(iterations,
+                [&] { sink += standx::base58_encode(data.data(), 32, text); }));
+  (void)sink;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+
+  crossCheck();
+  if (failures > 0) {
+    printf("%d mismatches\n", failures);
+    return 1;
+  }
+  printf("round trips and reference cross-check passed\n\n");
+
+  benchmark(iterations);
+  return 0;
+}
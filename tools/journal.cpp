@@ -0,0 +1,219 @@
+// Decode, filter and export a binary trade journal.
+//
+//   standx_journal <journal.bin> [options]
+//
+// The file is memory-mapped; sequence numbers are contiguous, so a
+// --from-seq start is found without scanning.
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "data.h"
+#include "journal.h"
+
+Config kConfig;
+
+namespace {
+
+constexpr size_t kEventCount = standx::kJournalEventCount;
+static_assert(kEventCount <= 32, "--event filters through a 32-bit mask");
+
+void usage() {
+  std::cerr
+      << "usage: standx_journal <journal.bin> [options]\n"
+         "  --symbol S        only records of symbol S\n"
+         "  --event LIST      e.g. place,fill,cancel; one of price, position,\n"
+         "                    place, reject, fill, cancel, cancel_failed\n"
+         "  --from-seq N      first sequence number\n"
+         "  --to-seq N        last sequence number\n"
+         "  --since MS        wall clock lower bound, ms since epoch\n"
+         "  --until MS        wall clock upper bound, ms since epoch\n"
+         "  --tail N          only the last N matching records\n"
+         "  --csv             CSV with a header line instead of a table\n"
+         "  --stats           counts per symbol and event, and sequence gaps\n";
+}
+
+std::string formatTime(int64_t ts_us) {
+  time_t seconds = static_cast<time_t>(ts_us / 1000000);
+  struct tm tm;
+  localtime_r(&seconds, &tm);
+  char text[40];
+  size_t n = strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &tm);
+  snprintf(text + n, sizeof(text) - n, ".%06d",
+           static_cast<int>(ts_us % 1000000));
+  return text;
+}
+
+double fixed(int64_t raw) { return static_cast<double>(Fixed::fromRaw(raw)); }
+
+const char* sideName(OrderSide side) {
+  switch (side) {
+    case OrderSide::kBuy: return "buy";
+    case OrderSide::kSell: return "sell";
+    default: return "-";
+  }
+}
+
+const char* positionName(PositionSide side) {
+  switch (side) {
+    case PositionSide::kLong: return "long";
+    case PositionSide::kShort: return "short";
+    default: return "-";
+  }
+}
+
+void printRecord(const standx::JournalRecord& r, bool csv) {
+  bool reduce_only = (r.flags & standx::kJournalReduceOnly) != 0;
+  std::string time = formatTime(r.ts_us);
+  std::string symbol = r.symbolName();
+  if (csv) {
+    printf("%" PRIu64 ",%s,%s,%s,%s,%s,%" PRId64 ",%.10g,%.10g,%.10g,%d\n",
+           r.seq, time.c_str(), symbol.c_str(), standx::toString(r.event),
+           sideName(r.side), positionName(r.position_side), r.order_id,
+           fixed(r.price), fixed(r.size), fixed(r.aux), reduce_only ? 1 : 0);
+  } else {
+    printf("%10" PRIu64 " %s %-8s %-13s %-4s %-5s %20" PRId64
+           " %14.10g %12.10g %14.10g %s\n",
+           r.seq, time.c_str(), symbol.c_str(), standx::toString(r.event),
+           sideName(r.side), positionName(r.position_side), r.order_id,
+           fixed(r.price), fixed(r.size), fixed(r.aux),
+           reduce_only ? "R" : "");
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    usage();
+    return 1;
+  }
+
+  std::string input = argv[1];
+  std::string symbol;
+  uint32_t event_mask = ~0u;
+  uint64_t from_seq = 0;
+  uint64_t to_seq = UINT64_MAX;
+  int64_t since_us = INT64_MIN;
+  int64_t until_us = INT64_MAX;
+  size_t tail = 0;
+  bool csv = false;
+  bool stats = false;
+
+  for (int i = 2; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool has_value = i + 1 < argc;
+    if (arg == "--csv") {
+      csv = true;
+    } else if (arg == "--stats") {
+      stats = true;
+    } else if (arg == "--symbol" && has_value) {
+      symbol = argv[++i];
+    } else if (arg == "--event" && has_value) {
+      event_mask = 0;
+      std::stringstream list(argv[++i]);
+      std::string name;
+      while (std::getline(list, name, ',')) {
+        standx::JournalEvent event;
+        if (!standx::parseJournalEvent(name, event)) {
+          std::cerr << "unknown event: " << name << std::endl;
+          return 1;
+        }
+        event_mask |= 1u << static_cast<unsigned>(event);
+      }
+    } else if (arg == "--from-seq" && has_value) {
+      from_seq = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--to-seq" && has_value) {
+      to_seq = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--since" && has_value) {
+      since_us = std::atoll(argv[++i]) * 1000;
+    } else if (arg == "--until" && has_value) {
+      until_us = std::atoll(argv[++i]) * 1000;
+    } else if (arg == "--tail" && has_value) {
+      tail = static_cast<size_t>(std::atoll(argv[++i]));
+    } else {
+      usage();
+      return 1;
+    }
+  }
+
+  standx::MappedJournal journal;
+  std::string error;
+  if (!journal.open(input, error)) {
+    std::cerr << error << std::endl;
+    return 1;
+  }
+  const standx::JournalRecord* records = journal.data();
+  size_t count = journal.size();
+
+  size_t begin = 0;
+  if (count > 0 && from_seq > records[0].seq) {
+    begin = std::min<uint64_t>(from_seq - records[0].seq, count);
+  }
+
+  std::vector<size_t> matches;
+  std::map<std::string, std::vector<uint64_t>> counts;
+  uint64_t gaps = 0;
+  for (size_t i = begin; i < count; ++i) {
+    const standx::JournalRecord& r = records[i];
+    if (i > 0 && r.seq != records[i - 1].seq + 1) ++gaps;
+    if (r.seq < from_seq) continue;
+    if (r.seq > to_seq) break;
+    if (r.ts_us < since_us || r.ts_us > until_us) continue;
+    unsigned event = static_cast<unsigned>(r.event);
+    if (event >= kEventCount || (event_mask & (1u << event)) == 0) continue;
+    if (!symbol.empty() && r.symbolName() != symbol) continue;
+    if (stats) {
+      auto& row = counts[r.symbolName()];
+      row.resize(kEventCount);
+      ++row[event];
+    } else {
+      matches.push_back(i);
+    }
+  }
+
+  if (stats) {
+    printf("%-10s", "symbol");
+    for (size_t e = 1; e < kEventCount; ++e) {
+      printf(" %13s", standx::toString(static_cast<standx::JournalEvent>(e)));
+    }
+    printf("\n");
+    for (const auto& entry : counts) {
+      printf("%-10s", entry.first.c_str());
+      for (size_t e = 1; e < kEventCount; ++e) {
+        printf(" %13" PRIu64, entry.second[e]);
+      }
+      printf("\n");
+    }
+    printf("records %zu", count);
+    if (count > 0) {
+      printf(", seq %" PRIu64 "..%" PRIu64 ", %s .. %s", records[0].seq,
+             records[count - 1].seq, formatTime(records[0].ts_us).c_str(),
+             formatTime(records[count - 1].ts_us).c_str());
+    }
+    printf(", gaps %" PRIu64 "\n", gaps);
+    return 0;
+  }
+
+  size_t first = tail > 0 && matches.size() > tail ? matches.size() - tail : 0;
+  if (csv) {
+    printf("seq,time,symbol,event,side,position_side,order_id,price,size,aux,"
+           "reduce_only\n");
+  } else {
+    printf("%10s %-26s %-8s %-13s %-4s %-5s %20s %14s %12s %14s\n", "seq",
+           "time", "symbol", "event", "side", "pos", "order_id", "price",
+           "size", "aux");
+  }
+  for (size_t i = first; i < matches.size(); ++i) {
+    printRecord(records[matches[i]], csv);
+  }
+  return 0;
+}
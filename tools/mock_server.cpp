@@ -0,0 +1,125 @@
+// Serve a local mock of the StandX REST API for load and latency tests.
+//
+//   standx_mock [options]
+//
+// Point the client at it with
+//   api.baseUrl = http://127.0.0.1:8080
+//   auth.baseUrl = http://127.0.0.1:8080
+//   ws.enable = false
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "data.h"
+#include "mock_server.h"
+#include "strategy_host.h"
+
+Config kConfig;
+
+namespace {
+
+std::atomic<bool> g_stop{false};
+
+void onSignal(int) { g_stop = true; }
+
+void usage() {
+  std::cerr
+      << "usage: standx_mock [options]\n"
+         "  --port N          listen port (default 8080)\n"
+         "  --threads N       handler threads (default 16)\n"
+         "  --symbols LIST    e.g. BTC-USD,ETH-USD (default BTC, ETH, SOL)\n"
+         "  --latency-ms N    delay before every response\n"
+         "  --jitter-ms N     plus a uniform random 0..N ms\n"
+         "  --error-rate P    share of requests answered 503\n"
+         "  --reject-rate P   share of new/cancel orders refused with 400\n"
+         "  --token-ttl S     access tokens expire after S seconds\n"
+         "  --tick-ms N       price walk step (default 100)\n"
+         "  --vol-bps X       price step standard deviation (default 2)\n"
+         "  --balance X       account balance (default 10000)\n"
+         "  --maker-bps X     maker fee (default 0)\n"
+         "  --taker-bps X     taker fee (default 5)\n"
+         "  --touch           fill resting orders on touch\n"
+         "  --report-s N      print request counts every N s (default 10)\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  standx::MockServerConfig config;
+  int report_s = 10;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool has_value = i + 1 < argc;
+    if (arg == "--touch") {
+      config.sim.fill_on_touch = true;
+    } else if (arg == "--port" && has_value) {
+      config.port = std::atoi(argv[++i]);
+    } else if (arg == "--threads" && has_value) {
+      config.threads = std::atoi(argv[++i]);
+    } else if (arg == "--symbols" && has_value) {
+      config.symbols = StrategyHost::ParseSymbols(argv[++i]);
+    } else if (arg == "--latency-ms" && has_value) {
+      config.latency_ms = std::atoi(argv[++i]);
+    } else if (arg == "--jitter-ms" && has_value) {
+      config.jitter_ms = std::atoi(argv[++i]);
+    } else if (arg == "--error-rate" && has_value) {
+      config.error_rate = std::atof(argv[++i]);
+    } else if (arg == "--reject-rate" && has_value) {
+      config.reject_rate = std::atof(argv[++i]);
+    } else if (arg == "--token-ttl" && has_value) {
+      config.token_ttl_s = std::atoi(argv[++i]);
+    } else if (arg == "--tick-ms" && has_value) {
+      config.tick_ms = std::atoi(argv[++i]);
+    } else if (arg == "--vol-bps" && has_value) {
+      config.volatility_bps = std::atof(argv[++i]);
+    } else if (arg == "--balance" && has_value) {
+      config.sim.initial_balance = std::atof(argv[++i]);
+    } else if (arg == "--maker-bps" && has_value) {
+      config.sim.maker_fee_bps = std::atof(argv[++i]);
+    } else if (arg == "--taker-bps" && has_value) {
+      config.sim.taker_fee_bps = std::atof(argv[++i]);
+    } else if (arg == "--report-s" && has_value) {
+      report_s = std::atoi(argv[++i]);
+    } else {
+      usage();
+      return 1;
+    }
+  }
+  if (config.symbols.empty() || config.tick_ms <= 0) {
+    usage();
+    return 1;
+  }
+
+  std::signal(SIGINT, onSignal);
+  std::signal(SIGTERM, onSignal);
+
+  standx::MockServer server(config);
+  server.start();
+  std::cout << "standx mock listening on port " << config.port << std::endl;
+
+  auto last_report = std::chrono::steady_clock::now();
+  while (!g_stop) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    auto now = std::chrono::steady_clock::now();
+    if (report_s <= 0 || now - last_report < std::chrono::seconds(report_s)) {
+      continue;
+    }
+    last_report = now;
+    uint64_t total = 0;
+    for (const auto& entry : server.requestCounts()) {
+      std::cout << entry.first << " " << entry.second << "\n";
+      total += entry.second;
+    }
+    std::cout << "total " << total << ", injected failures "
+              << server.injectedFailures() << std::endl;
+  }
+
+  server.stop();
+  return 0;
+}
@@ -0,0 +1,286 @@
+// Run the grid backtest over a grid of parameters on every core and print
+// the configurations ranked by result.
+//
+//   standx_sweep <ticks.bin|ticks.csv> [options]
+//
+// Parameter lists are either "a,b,c" or an inclusive range "lo:hi:step".
+// A binary tick file is memory-mapped once and shared read-only by all
+// workers; convert CSV with "standx_backtest ticks.csv --convert ticks.bin".
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Poco/File.h"
+#include "backtest.h"
+#include "data.h"
+#include "strategy.h"
+#include "tick_file.h"
+#include "tracer.h"
+
+Config kConfig;
+
+namespace {
+
+struct Run {
+  GridParams params;
+  standx::BacktestResult result;
+  double net_pnl{0.0};
+  double score{0.0};
+};
+
+void usage() {
+  std::cerr
+      << "usage: standx_sweep <ticks.bin|ticks.csv> [options]\n"
+         "  --symbol S        symbol whose defaults fill unset lists\n"
+         "  --long/--short    grid to run (default --short)\n"
+         "  --interval LIST   level spacing\n"
+         "  --size LIST       grid order size\n"
+         "  --order-num LIST  place orders per side\n"
+         "  --factor LIST     position cap factor\n"
+         "  --tp-levels LIST  TP window offset in levels\n"
+         "  --step-ms N       strategy timer in simulated ms (default 1000)\n"
+         "  --threads N       workers (default: all cores)\n"
+         "  --rank pnl|ratio  sort by net pnl or pnl / max drawdown\n"
+         "  --top N           rows to print (default 20)\n"
+         "  --csv FILE        also write every run as CSV\n"
+         "  --balance X, --maker-bps X, --taker-bps X, --touch\n"
+         "                    as for standx_backtest\n";
+}
+
+// "a,b,c" or "lo:hi:step"; empty on a malformed list.
+std::vector<double> parseList(const std::string& text) {
+  std::vector<double> values;
+  size_t colon = text.find(':');
+  if (colon != std::string::npos) {
+    size_t colon2 = text.find(':', colon + 1);
+    if (colon2 == std::string::npos) return values;
+    double lo = std::atof(text.substr(0, colon).c_str());
+    double hi = std::atof(text.substr(colon + 1, colon2 - colon - 1).c_str());
+    double step = std::atof(text.substr(colon2 + 1).c_str());
+    if (step <= 0 || hi < lo) return values;
+    // Index-based so float steps do not drift past hi.
+    for (int i = 0; lo + i * step <= hi + step * 1e-9; ++i) {
+      values.push_back(lo + i * step);
+    }
+    return values;
+  }
+  size_t begin = 0;
+  while (begin <= text.size()) {
+    size_t comma = text.find(',', begin);
+    if (comma == std::string::npos) comma = text.size();
+    std::string item = text.substr(begin, comma - begin);
+    if (!item.empty()) values.push_back(std::atof(item.c_str()));
+    begin = comma + 1;
+  }
+  return values;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    usage();
+    return 1;
+  }
+
+  std::string input = argv[1];
+  std::string csv_file;
+  std::string rank = "pnl";
+  bool grid_long = false;
+  bool grid_short = false;
+  size_t top = 20;
+  size_t threads = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<double> intervals, sizes, order_nums, factors, tp_levels;
+  standx::BacktestOptions options;
+
+  for (int i = 2; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool has_value = i + 1 < argc;
+    if (arg == "--long") {
+      grid_long = true;
+    } else if (arg == "--short") {
+      grid_short = true;
+    } else if (arg == "--touch") {
+      options.sim.fill_on_touch = true;
+    } else if (arg == "--symbol" && has_value) {
+      options.sim.symbol = argv[++i];
+    } else if (arg == "--interval" && has_value) {
+      intervals = parseList(argv[++i]);
+    } else if (arg == "--size" && has_value) {
+      sizes = parseList(argv[++i]);
+    } else if (arg == "--order-num" && has_value) {
+      order_nums = parseList(argv[++i]);
+    } else if (arg == "--factor" && has_value) {
+      factors = parseList(argv[++i]);
+    } else if (arg == "--tp-levels" && has_value) {
+      tp_levels = parseList(argv[++i]);
+    } else if (arg == "--step-ms" && has_value) {
+      options.step_ms = std::atoll(argv[++i]);
+    } else if (arg == "--threads" && has_value) {
+      threads = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "--rank" && has_value) {
+      rank = argv[++i];
+    } else if (arg == "--top" && has_value) {
+      top = std::max(0, std::atoi(argv[++i]));
+    } else if (arg == "--csv" && has_value) {
+      csv_file = argv[++i];
+    } else if (arg == "--balance" && has_value) {
+      options.sim.initial_balance = std::atof(argv[++i]);
+    } else if (arg == "--maker-bps" && has_value) {
+      options.sim.maker_fee_bps = std::atof(argv[++i]);
+    } else if (arg == "--taker-bps" && has_value) {
+      options.sim.taker_fee_bps = std::atof(argv[++i]);
+    } else {
+      usage();
+      return 1;
+    }
+  }
+  if (rank != "pnl" && rank != "ratio") {
+    usage();
+    return 1;
+  }
+
+  // Binary files are shared through one mapping; CSV is parsed once.
+  const standx::Tick* ticks = nullptr;
+  size_t tick_count = 0;
+  standx::MappedTicks mapped;
+  std::vector<standx::Tick> loaded;
+  std::string error;
+  bool csv = input.size() > 4 && input.substr(input.size() - 4) == ".csv";
+  if (csv ? !standx::loadTicks(input, loaded, error)
+          : !mapped.open(input, error)) {
+    std::cerr << error << std::endl;
+    return 1;
+  }
+  ticks = csv ? loaded.data() : mapped.data();
+  tick_count = csv ? loaded.size() : mapped.size();
+  if (tick_count == 0) {
+    std::cerr << "no ticks in " << input << std::endl;
+    return 1;
+  }
+
+  kConfig.gridLong = grid_long;
+  kConfig.gridShort = grid_short || !grid_long;
+  kConfig.subBtcSize = 0.0001;
+  kConfig.subEthSize = 0.001;
+  kConfig.subSolSize = 0.05;
+  kConfig.strategyWaitStrategy = "block";
+  kConfig.strategyTickIntervalMs = 1000;
+  kConfig.strategyCpu = -1;
+  Poco::File("log").createDirectories();
+  logger::Tracer::Init("default", "log/sweep.log", "100M");
+  logger::Tracer::SetLevel("fatal");
+
+  GridParams defaults = Strategy::DefaultParams(options.sim.symbol);
+  if (intervals.empty()) intervals.push_back(defaults.order_interval);
+  if (sizes.empty()) sizes.push_back(defaults.grid_size);
+  if (order_nums.empty()) order_nums.push_back(defaults.order_num);
+  if (factors.empty()) factors.push_back(defaults.max_order_num_factor);
+  if (tp_levels.empty()) tp_levels.push_back(defaults.tp_levels);
+
+  std::vector<Run> runs;
+  for (double interval : intervals) {
+    for (double size : sizes) {
+      for (double order_num : order_nums) {
+        for (double factor : factors) {
+          for (double tp : tp_levels) {
+            Run run;
+            run.params = defaults;
+            run.params.order_interval = interval;
+            run.params.grid_size = size;
+            run.params.order_num = static_cast<int>(order_num);
+            run.params.max_order_num_factor = factor;
+            run.params.tp_levels = static_cast<int>(tp);
+            runs.push_back(run);
+          }
+        }
+      }
+    }
+  }
+  threads = std::min(threads, runs.size());
+  std::cerr << runs.size() << " runs over " << tick_count << " ticks on "
+            << threads << " threads" << std::endl;
+
+  // Workers pull the next configuration off a shared counter, so long and
+  // short runs balance out across cores.
+  auto started = std::chrono::steady_clock::now();
+  std::atomic<size_t> next{0};
+  std::atomic<size_t> done{0};
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < threads; ++t) {
+    workers.emplace_back([&]() {
+      for (size_t i = next++; i < runs.size(); i = next++) {
+        standx::BacktestOptions run_options = options;
+        run_options.params = runs[i].params;
+        runs[i].result = standx::runBacktest(ticks, tick_count, run_options);
+        size_t finished = ++done;
+        if (finished % std::max<size_t>(runs.size() / 10, 1) == 0) {
+          std::cerr << finished << "/" << runs.size() << " done" << std::endl;
+        }
+      }
+    });
+  }
+  for (auto& worker : workers) worker.join();
+  double wall = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - started)
+                    .count();
+
+  for (auto& run : runs) {
+    run.net_pnl = run.result.final_equity - options.sim.initial_balance;
+    double drawdown = std::max(run.result.stats.max_drawdown, 1e-9);
+    run.score = rank == "ratio" ? run.net_pnl / drawdown : run.net_pnl;
+  }
+  std::sort(runs.begin(), runs.end(),
+            [](const Run& a, const Run& b) { return a.score > b.score; });
+
+  std::cout << std::fixed << std::setprecision(4) << std::left
+            << std::setw(5) << "#" << std::setw(11) << "interval"
+            << std::setw(10) << "size" << std::setw(6) << "num"
+            << std::setw(7) << "factor" << std::setw(4) << "tp"
+            << std::right << std::setw(14) << "net_pnl" << std::setw(12)
+            << "fees" << std::setw(12) << "max_dd" << std::setw(9)
+            << "fills" << std::setw(10) << "requests" << "\n";
+  for (size_t i = 0; i < runs.size() && i < top; ++i) {
+    const Run& run = runs[i];
+    const standx::SimStats& s = run.result.stats;
+    std::cout << std::left << std::setw(5) << i + 1 << std::setw(11)
+              << run.params.order_interval << std::setw(10)
+              << run.params.grid_size << std::setw(6) << run.params.order_num
+              << std::setw(7) << run.params.max_order_num_factor
+              << std::setw(4) << run.params.tp_levels << std::right
+              << std::setw(14) << run.net_pnl << std::setw(12) << s.fees
+              << std::setw(12) << s.max_drawdown << std::setw(9)
+              << s.maker_fills + s.taker_fills << std::setw(10)
+              << s.place_requests + s.cancel_requests + s.amend_requests
+              << "\n";
+  }
+  std::cout << runs.size() << " runs in " << wall << " s; fills "
+            << standx::describeFillModel(options.sim) << std::endl;
+
+  if (!csv_file.empty()) {
+    std::ofstream out(csv_file);
+    out << "interval,size,order_num,factor,tp_levels,net_pnl,realized_pnl,"
+           "fees,max_drawdown,maker_fills,taker_fills,place_requests,"
+           "cancel_requests,amend_requests\n";
+    out << std::setprecision(8);
+    for (const auto& run : runs) {
+      const standx::SimStats& s = run.result.stats;
+      out << run.params.order_interval << "," << run.params.grid_size << ","
+          << run.params.order_num << "," << run.params.max_order_num_factor
+          << "," << run.params.tp_levels << "," << run.net_pnl << ","
+          << s.realized_pnl << "," << s.fees << "," << s.max_drawdown << ","
+          << s.maker_fills << "," << s.taker_fills << ","
+          << s.place_requests << "," << s.cancel_requests << ","
+          << s.amend_requests << "\n";
+    }
+  }
+  return 0;
+}